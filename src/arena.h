@@ -0,0 +1,60 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <stddef.h>
+
+// Linear (bump) allocator for data that only lives for one frame.
+// Allocating is a pointer bump, and everything is freed at once by arena_reset().
+// The arena also remembers the most it has had in use, for sizing it.
+struct Arena {
+    Uint8 *base;
+    size_t capacity;
+    size_t used;
+    size_t peak;   // Most bytes in use at once since the last arena_take_peak()
+    Uint32 failed; // Allocations that didn't fit, since the last arena_take_peak()
+};
+
+static inline bool arena_init(struct Arena *arena, size_t capacity) {
+    arena->base = (Uint8 *)SDL_aligned_alloc(64, capacity);
+    arena->capacity = arena->base ? capacity : 0;
+    arena->used = 0;
+    arena->peak = 0;
+    arena->failed = 0;
+    return arena->base != NULL;
+}
+
+static inline void arena_destroy(struct Arena *arena) {
+    SDL_aligned_free(arena->base);
+    arena->base = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+// Returns NULL when the arena is full. align must be a power of two.
+static inline void *arena_alloc(struct Arena *arena, size_t size, size_t align = alignof(max_align_t)) {
+    size_t start = (arena->used + align - 1) & ~(align - 1);
+    if (start + size > arena->capacity) {
+        arena->failed++;
+        return NULL;
+    }
+    arena->used = start + size;
+    return arena->base + start;
+}
+
+template <typename T>
+static inline T *arena_alloc_array(struct Arena *arena, size_t count) {
+    return (T *)arena_alloc(arena, sizeof(T) * count, alignof(T));
+}
+
+static inline void arena_reset(struct Arena *arena) {
+    arena->peak = SDL_max(arena->peak, arena->used);
+    arena->used = 0;
+}
+
+// Peak use since the last call (including what is in use now), and start measuring again
+static inline size_t arena_take_peak(struct Arena *arena) {
+    size_t peak = SDL_max(arena->peak, arena->used);
+    arena->peak = 0;
+    arena->failed = 0;
+    return peak;
+}
@@ -0,0 +1,1017 @@
+#include "game_config.h"
+#include "bench.h"
+#include "upscale.h"
+#include "sim.h"
+#include "snapshot.h"
+#include "particles.h"
+#include "palette.h"
+#include "displaylist.h"
+#include "raster.h"
+#include "draw.h"
+#include "input.h"
+#include <SDL3/SDL.h>
+
+#define BENCH_ITERATIONS 200
+#define SIM_BENCH_TICKS 200000
+// Drift between the float and fixed-point simulations allowed at any point in an hour of play
+#define SIM_DRIFT_TICKS 216000
+#define SIM_DRIFT_LIMIT 1.0f
+// Asteroid speeds are rounded to Q2.14, so each tick they may move up to half
+// a step further on each axis than in the float simulation
+#define SIM_ASTEROID_DRIFT_PER_TICK (1.0f / 16384.0f)
+#define SNAPSHOT_ITERATIONS 10000
+#define FRAME_BUDGET_NS 16666666
+// Simulated link for the rollback session: latency and jitter in ticks
+#define ROLLBACK_TICKS 3600
+#define ROLLBACK_LATENCY 6
+#define ROLLBACK_JITTER 3
+#define PARTICLE_FRAMES 600
+#define PALETTE_ITERATIONS 2000
+#define DISPLAY_LIST_ITERATIONS 2000
+// Game frames checked against immediate drawing
+#define DISPLAY_LIST_CHECK_TICKS 6000
+#define DISPLAY_LIST_CHECK_EVERY 100
+#define RASTER_SHAPES 4000
+
+bool bench_requested() {
+    return SDL_getenv("ASTEROIDS_BENCH") != NULL;
+}
+
+// Check whether `name` appears in the ASTEROIDS_BENCH list
+static bool bench_enabled(const char *name) {
+    const char *list = SDL_getenv("ASTEROIDS_BENCH");
+    if (!list) {
+        return false;
+    }
+    if (SDL_strcmp(list, "all") == 0 || SDL_strcmp(list, "1") == 0) {
+        return true;
+    }
+    size_t len = SDL_strlen(name);
+    for (const char *p = list; *p; ) {
+        const char *end = SDL_strchr(p, ',');
+        size_t item = end ? (size_t)(end - p) : SDL_strlen(p);
+        if (item == len && SDL_strncmp(p, name, len) == 0) {
+            return true;
+        }
+        if (!end) {
+            break;
+        }
+        p = end + 1;
+    }
+    return false;
+}
+
+static void report(const char *group, const char *name, Uint64 total_ns, int iterations) {
+    SDL_Log("[%s] %-24s %9.2f us/iter", group, name, total_ns / 1000.0 / iterations);
+}
+
+// Our integer upscaler against SDL's own nearest neighbour scaling at the game's resolution.
+// Returns the number of kernels that don't match SDL.
+static int bench_upscale() {
+    const int scale = PIXEL_SIZE;
+    const int src_pitch = WIDTH * 4;
+    const int dst_pitch = WIDTH * scale * 4;
+    Uint32 *src = (Uint32 *)SDL_aligned_alloc(64, (size_t)src_pitch * HEIGHT);
+    Uint32 *dst = (Uint32 *)SDL_aligned_alloc(64, (size_t)dst_pitch * HEIGHT * scale);
+    Uint32 *reference = (Uint32 *)SDL_aligned_alloc(64, (size_t)dst_pitch * HEIGHT * scale);
+    if (!src || !dst || !reference) {
+        SDL_Log("[upscale] out of memory");
+        SDL_aligned_free(src);
+        SDL_aligned_free(dst);
+        SDL_aligned_free(reference);
+        return 1;
+    }
+
+    // Any pattern works for timing, but make it vary per pixel so mistakes show up in the comparison
+    for (int i = 0; i < WIDTH * HEIGHT; i++) {
+        src[i] = (Uint32)i * 2654435761u;
+    }
+
+    SDL_Surface *src_surface = SDL_CreateSurfaceFrom(WIDTH, HEIGHT, SDL_PIXELFORMAT_XBGR8888, src, src_pitch);
+    SDL_Surface *dst_surface = SDL_CreateSurfaceFrom(WIDTH * scale, HEIGHT * scale, SDL_PIXELFORMAT_XBGR8888, reference, dst_pitch);
+    if (src_surface && dst_surface) {
+        Uint64 start = SDL_GetTicksNS();
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            SDL_BlitSurfaceScaled(src_surface, NULL, dst_surface, NULL, SDL_SCALEMODE_NEAREST);
+        }
+        report("upscale", "SDL_BlitSurfaceScaled", SDL_GetTicksNS() - start, BENCH_ITERATIONS);
+    } else {
+        SDL_Log("[upscale] could not create surfaces: %s", SDL_GetError());
+    }
+
+    int failures = 0;
+    for (int led = 0; led < 2; led++) {
+        for (int k = 0; k < UPSCALE_KERNEL_COUNT; k++) {
+            if (!upscale_kernel_supported((UpscaleKernel)k)) {
+                continue;
+            }
+            struct Upscaler up;
+            if (!upscaler_init(&up, WIDTH, HEIGHT, scale, led != 0)) {
+                continue;
+            }
+            up.kernel = (UpscaleKernel)k;
+
+            Uint64 start = SDL_GetTicksNS();
+            for (int i = 0; i < BENCH_ITERATIONS; i++) {
+                upscale(&up, (const char *)src, src_pitch, (char *)dst, dst_pitch);
+            }
+            char name[32];
+            SDL_snprintf(name, sizeof(name), "%s%s", upscale_kernel_name(up.kernel), led ? " + led mask" : "");
+            report("upscale", name, SDL_GetTicksNS() - start, BENCH_ITERATIONS);
+
+            // Without the mask we must produce exactly what SDL does
+            if (!led && src_surface && dst_surface) {
+                int mismatches = 0;
+                for (int i = 0; i < WIDTH * scale * HEIGHT * scale; i++) {
+                    mismatches += (dst[i] != reference[i]);
+                }
+                if (mismatches) {
+                    SDL_Log("[upscale] %s: FAIL, differs from SDL in %d pixels", name, mismatches);
+                    failures++;
+                }
+            }
+            upscaler_destroy(&up);
+        }
+    }
+
+    SDL_DestroySurface(src_surface);
+    SDL_DestroySurface(dst_surface);
+    SDL_aligned_free(src);
+    SDL_aligned_free(dst);
+    SDL_aligned_free(reference);
+    return failures;
+}
+
+// Deterministic input: thrust in bursts, turn now and then, optionally shoot
+static void scripted_input(int tick, bool shoot, EVENTS *key_events) {
+    key_events->thrust_flag = (tick % 300) < 40;
+    key_events->left_flag = (tick % 500) == 0;
+    key_events->right_flag = (tick % 700) == 0;
+    key_events->shoot_flag = shoot; // Held, the cooldown paces the shots
+}
+
+template <typename Sim>
+static void bench_sim_ticks(const char *name) {
+    static GameState<Sim> state;
+    sim_init(&state, 54321);
+
+    EVENTS key_events;
+    Uint64 start = SDL_GetTicksNS();
+    for (int tick = 0; tick < SIM_BENCH_TICKS; tick++) {
+        scripted_input(tick, true, &key_events);
+        sim_step(&state, &key_events);
+    }
+    Uint64 elapsed = SDL_GetTicksNS() - start;
+    SDL_Log("[sim] %-6s %10.0f ticks/sec (player %d bytes, asteroid %d bytes, bullet %d bytes)", name,
+            SIM_BENCH_TICKS / (elapsed / 1e9), (int)sizeof(PlayerT<Sim>), (int)sizeof(AsteroidT<Sim>), (int)sizeof(BulletT<Sim>));
+}
+
+// Horizontal distance on the wrapping playfield
+static float wrapped_distance(float a, float b) {
+    float d = SDL_fabsf(a - b);
+    return d > WIDTH / 2 ? WIDTH - d : d;
+}
+
+// Run both simulations side by side without shooting (so random respawns
+// can't send them down different paths) and track how far apart they get,
+// beyond what rounding the asteroid speeds accounts for.
+// Returns the number of checkpoints where they were too far apart.
+static int bench_sim_drift() {
+    static GameState<FloatSim> reference;
+    static GameState<FixedSim> fixed;
+    sim_init(&reference, 54321);
+    sim_init(&fixed, 54321);
+
+    const int checkpoints[] = { 600, 3600, 36000, SIM_DRIFT_TICKS };
+    int next_checkpoint = 0;
+    int failures = 0;
+    float player_drift = 0;
+    float asteroid_drift = 0;
+    EVENTS key_events;
+    for (int tick = 1; tick <= checkpoints[SDL_arraysize(checkpoints) - 1]; tick++) {
+        scripted_input(tick, false, &key_events);
+        sim_step(&reference, &key_events);
+        sim_step(&fixed, &key_events);
+
+        float d = wrapped_distance(reference.player.x, (float)fixed.player.x) + SDL_fabsf(reference.player.y - (float)fixed.player.y);
+        player_drift = SDL_max(player_drift, d);
+        for (int i = 0; i < reference.asteroid_count; i++) {
+            d = wrapped_distance(reference.asteroids[i].x, (float)fixed.asteroids[i].x) + SDL_fabsf(reference.asteroids[i].y - (float)fixed.asteroids[i].y);
+            asteroid_drift = SDL_max(asteroid_drift, d);
+        }
+
+        if (tick == checkpoints[next_checkpoint]) {
+            float asteroid_limit = SIM_DRIFT_LIMIT + tick * SIM_ASTEROID_DRIFT_PER_TICK;
+            SDL_Log("[sim] drift after %6d ticks: player %.3f px, asteroids %.3f px (%.3f allowed)", tick, player_drift, asteroid_drift, asteroid_limit);
+            if (player_drift > SIM_DRIFT_LIMIT || asteroid_drift > asteroid_limit) {
+                SDL_Log("[sim] FAIL: fixed-point drifted further from float than allowed in %d ticks", tick);
+                failures++;
+            }
+            next_checkpoint++;
+        }
+    }
+    return failures;
+}
+
+// Cost of saving/restoring a snapshot of a busy game, and of replaying history
+static void bench_snapshot() {
+    static GameState<GameSim> state;
+    static GameState<GameSim> copy;
+    static SnapshotHistory<GameSim> history;
+    sim_init(&state, 54321);
+
+    // Play a while so there are plenty of bullets to copy
+    EVENTS key_events;
+    for (int tick = 0; tick < 3000; tick++) {
+        scripted_input(tick, true, &key_events);
+        sim_tick(&state, &key_events);
+    }
+
+    // Cycle through the history slots so the compiler can't drop repeated copies
+    volatile Uint32 sink = 0;
+    Uint64 start = SDL_GetTicksNS();
+    for (int i = 0; i < SNAPSHOT_ITERATIONS; i++) {
+        snapshot_copy(&history.states[i & (SNAPSHOT_HISTORY - 1)], &state);
+    }
+    report("snapshot", "save", SDL_GetTicksNS() - start, SNAPSHOT_ITERATIONS);
+    start = SDL_GetTicksNS();
+    for (int i = 0; i < SNAPSHOT_ITERATIONS; i++) {
+        snapshot_copy(&copy, &history.states[i & (SNAPSHOT_HISTORY - 1)]);
+        sink = sink + (Uint32)copy.rng;
+    }
+    report("snapshot", "restore", SDL_GetTicksNS() - start, SNAPSHOT_ITERATIONS);
+    SDL_Log("[snapshot] %d of %d bytes copied (%d bullets)", (int)snapshot_size(&state), (int)sizeof(state), state.bullet_count);
+
+    // Fill the history, then replay all of it
+    history_reset(&history, &state);
+    for (int tick = 0; tick < SNAPSHOT_HISTORY; tick++) {
+        scripted_input(tick, true, &key_events);
+        history_record(&history, &state, &key_events);
+        sim_tick(&state, &key_events);
+    }
+    start = SDL_GetTicksNS();
+    int replayed = history_resimulate(&history, &state, history.oldest_tick);
+    Uint64 elapsed = SDL_GetTicksNS() - start;
+    report("snapshot", "resimulate one tick", elapsed, replayed);
+    SDL_Log("[snapshot] %d ticks can be replayed within a 60 FPS frame", (int)((Uint64)FRAME_BUDGET_NS * replayed / SDL_max(elapsed, (Uint64)1)));
+}
+
+// Play a while with telemetry on, rewind to the start and play the same again.
+// The counters must end up as if the rewound ticks never ran. Returns 1 if not.
+static int check_rewind_telemetry() {
+    static GameState<GameSim> state;
+    static SnapshotHistory<GameSim> history;
+    sim_init(&state, 54321);
+    history_reset(&history, &state);
+
+    eventlog_set_muted(false);
+    Uint32 start_shots = telemetry_count(EV_SHOT);
+    Uint32 start_tick = state.tick;
+    EVENTS key_events;
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            history_rewind(&history, &state, start_tick);
+        }
+        for (int tick = 0; tick < SNAPSHOT_HISTORY; tick++) {
+            scripted_input(tick, true, &key_events);
+            history_record(&history, &state, &key_events);
+            sim_tick(&state, &key_events);
+        }
+    }
+    Uint32 shots = telemetry_count(EV_SHOT) - start_shots;
+    history_rewind(&history, &state, start_tick);
+    Uint32 rewound_shots = telemetry_count(EV_SHOT) - start_shots;
+    eventlog_set_muted(true);
+
+    SDL_Log("[snapshot] %u shots counted over a rewind and replay, %u after rewinding again", shots, rewound_shots);
+    if (shots == 0 || shots > SNAPSHOT_HISTORY / SHOT_COOLDOWN_TICKS + 1 || rewound_shots != 0) {
+        SDL_Log("[snapshot] FAIL: rewinding doesn't restore the telemetry counters");
+        return 1;
+    }
+    return 0;
+}
+
+// Two peers sharing one ship over links with latency, both must end up with the same state.
+// Returns 1 if they didn't.
+static int bench_rollback() {
+    static RollbackSession<GameSim> peers[2];
+    static struct SimLink links[2]; // links[i] carries peer i's input to the other peer
+    rollback_init(&peers[0], 54321);
+    rollback_init(&peers[1], 54321);
+    sim_link_init(&links[0], ROLLBACK_LATENCY, ROLLBACK_JITTER, 1);
+    sim_link_init(&links[1], ROLLBACK_LATENCY, ROLLBACK_JITTER, 2);
+
+    Uint64 worst_ns = 0;
+    for (Uint32 now = 0; now < ROLLBACK_TICKS; now++) {
+        // One peer steers, the other shoots
+        EVENTS inputs[2];
+        scripted_input(now, false, &inputs[0]);
+        SDL_memset(&inputs[1], 0, sizeof(inputs[1]));
+        inputs[1].shoot_flag = (now / 20) % 3 == 0;
+
+        for (int i = 0; i < 2; i++) {
+            Uint64 start = SDL_GetTicksNS();
+            rollback_receive(&peers[i], &links[1 - i], now);
+            rollback_advance(&peers[i], &links[i], now, &inputs[i]);
+            worst_ns = SDL_max(worst_ns, SDL_GetTicksNS() - start);
+        }
+    }
+
+    // Deliver everything still on the wire, then compare
+    for (int i = 0; i < 2; i++) {
+        rollback_receive(&peers[i], &links[1 - i], ROLLBACK_TICKS + ROLLBACK_LATENCY + ROLLBACK_JITTER + SIM_LINK_CAPACITY);
+        SDL_Log("[rollback] peer %d: %d rollbacks, %d ticks replayed (max %d at once)%s", i,
+                peers[i].rollbacks, peers[i].ticks_replayed, peers[i].max_replayed, peers[i].desynced ? ", DESYNCED" : "");
+    }
+    SDL_Log("[rollback] worst frame %.2f us with %d+-%d ticks latency", worst_ns / 1000.0, ROLLBACK_LATENCY, ROLLBACK_JITTER);
+    bool in_sync = sim_state_equal(&peers[0].state, &peers[1].state) && !peers[0].desynced && !peers[1].desynced;
+    SDL_Log("[rollback] %s after %d ticks", in_sync ? "peers in sync" : "FAIL: peers diverged", ROLLBACK_TICKS);
+    return in_sync ? 0 : 1;
+}
+
+// A screen kept as full of particles as the pool allows
+static void bench_particles() {
+    static ParticlePool pool;
+    char *pixels = (char *)SDL_aligned_alloc(64, (size_t)FB_PITCH * HEIGHT);
+    if (!pixels) {
+        return;
+    }
+    SDL_memset(pixels, 0, (size_t)FB_PITCH * HEIGHT);
+    particles_init(&pool, 1);
+
+    unsigned long rng = 1;
+    Uint64 spawn_ns = 0, update_ns = 0, draw_ns = 0;
+    int live = 0;
+    static constexpr ParticleScalar speed = ParticleScalar(0.3f);
+    for (int frame = 0; frame < PARTICLE_FRAMES; frame++) {
+        Uint64 start = SDL_GetTicksNS();
+        particles_begin_frame(&pool);
+        // Explosions all over the screen, slow enough that they mostly stay on it
+        while (pool.count < PARTICLE_CAPACITY && pool.spawned_this_frame < PARTICLE_SPAWN_CAP) {
+            ParticleScalar x = ParticleScalar(random_range(&rng, 10, WIDTH - 10));
+            ParticleScalar y = ParticleScalar(random_range(&rng, 10, HEIGHT - 10));
+            particles_spawn_burst(&pool, x, y, 64, speed, 240, particle_color(110, 80, 30));
+        }
+        Uint64 spawned = SDL_GetTicksNS();
+        particles_update(&pool, WIDTH, HEIGHT);
+        Uint64 updated = SDL_GetTicksNS();
+        particles_draw(&pool, pixels, FB_PITCH, NULL, 0, 0);
+        Uint64 drawn = SDL_GetTicksNS();
+        spawn_ns += spawned - start;
+        update_ns += updated - spawned;
+        draw_ns += drawn - updated;
+        live += pool.count;
+    }
+
+    report("particles", "spawn", spawn_ns, PARTICLE_FRAMES);
+    report("particles", "update", update_ns, PARTICLE_FRAMES);
+    report("particles", "blend", draw_ns, PARTICLE_FRAMES);
+    double frame_us = (spawn_ns + update_ns + draw_ns) / 1000.0 / PARTICLE_FRAMES;
+    SDL_Log("[particles] %d live on average (capacity %d, %d spawns per frame), %.2f us/frame = %.1f%% of a 60 FPS frame",
+            live / PARTICLE_FRAMES, PARTICLE_CAPACITY, PARTICLE_SPAWN_CAP, frame_us, frame_us * 100000.0 / FRAME_BUDGET_NS);
+    SDL_aligned_free(pixels);
+}
+
+// Expanding an indexed frame with each kernel, and what clearing the frame costs at 1 and 4 bytes per pixel.
+// Returns the number of kernels that don't match the scalar one.
+static int bench_palette() {
+    Uint8 *indices = (Uint8 *)SDL_aligned_alloc(64, (size_t)INDEX_PITCH * HEIGHT);
+    char *pixels = (char *)SDL_aligned_alloc(64, (size_t)FB_PITCH * HEIGHT);
+    char *reference = (char *)SDL_aligned_alloc(64, (size_t)FB_PITCH * HEIGHT);
+    if (!indices || !pixels || !reference) {
+        SDL_aligned_free(indices);
+        SDL_aligned_free(pixels);
+        SDL_aligned_free(reference);
+        return 1;
+    }
+    // Every palette entry, not just the game's colors
+    struct Palette pal;
+    palette_init(&pal);
+    for (int i = PAL_GAME_COLORS; i < PALETTE_SIZE; i++) {
+        palette_set(&pal, i, i * 16, 255 - i * 16, i * 5);
+    }
+    for (int i = 0; i < INDEX_PITCH * HEIGHT; i++) {
+        indices[i] = (Uint8)(i * 7 + i / 13);
+    }
+    pal.kernel = PALETTE_SCALAR;
+    palette_expand(&pal, indices, INDEX_PITCH, reference, FB_PITCH, WIDTH, HEIGHT);
+
+    int failures = 0;
+    for (int k = 0; k < PALETTE_KERNEL_COUNT; k++) {
+        PaletteKernel kernel = (PaletteKernel)k;
+        if (!palette_kernel_supported(kernel)) {
+            continue;
+        }
+        pal.kernel = kernel;
+        Uint64 start = SDL_GetTicksNS();
+        for (int i = 0; i < PALETTE_ITERATIONS; i++) {
+            palette_expand(&pal, indices, INDEX_PITCH, pixels, FB_PITCH, WIDTH, HEIGHT);
+        }
+        report("palette", palette_kernel_name(kernel), SDL_GetTicksNS() - start, PALETTE_ITERATIONS);
+        if (SDL_memcmp(pixels, reference, (size_t)FB_PITCH * HEIGHT) != 0) {
+            SDL_Log("[palette] %s: FAIL, differs from scalar", palette_kernel_name(kernel));
+            failures++;
+        }
+    }
+
+    volatile Uint8 sink = 0;
+    Uint64 start = SDL_GetTicksNS();
+    for (int i = 0; i < PALETTE_ITERATIONS; i++) {
+        SDL_memset(indices, i, (size_t)INDEX_PITCH * HEIGHT);
+        sink = sink + indices[i];
+    }
+    report("palette", "clear 8 bit frame", SDL_GetTicksNS() - start, PALETTE_ITERATIONS);
+    start = SDL_GetTicksNS();
+    for (int i = 0; i < PALETTE_ITERATIONS; i++) {
+        SDL_memset(pixels, i, (size_t)FB_PITCH * HEIGHT);
+        sink = sink + (Uint8)pixels[i];
+    }
+    report("palette", "clear 32 bit frame", SDL_GetTicksNS() - start, PALETTE_ITERATIONS);
+
+    SDL_aligned_free(indices);
+    SDL_aligned_free(pixels);
+    SDL_aligned_free(reference);
+    return failures;
+}
+
+// What the game draws in a frame of play, through the same draw calls as the game.
+// With `previous`, the frame is recorded on top of that one, so the optimizer
+// has something to remove.
+static void draw_game_frame(struct DisplayList *list, const GameState<GameSim> *state, const GameState<GameSim> *previous,
+                            const Sint16 shapes[MAX_ASTEROIDS][ASTEROID_VERTICES][2]) {
+    char score_text[32];
+    if (previous) {
+        SDL_snprintf(score_text, sizeof(score_text), "Score: %d", previous->player.score);
+        draw_game(list, previous, shapes, score_text);
+    }
+    draw_rect(list, 0, 0, WIDTH, HEIGHT, PAL_BLACK);
+    SDL_snprintf(score_text, sizeof(score_text), "Score: %d", state->player.score);
+    draw_game(list, state, shapes, score_text);
+}
+
+// Device controller messages and what they must decode to
+struct ControllerCase {
+    const char *message;
+    bool left, right, shoot, thrust;
+};
+
+static const struct ControllerCase controller_cases[] = {
+    { "50050000", false, false, false, false }, // At rest
+    { "52050010", false, false, true, false },  // Right at the edge of the dead zone
+    { "52150001", false, true, false, true },   // Just past it
+    { "48099900", false, false, false, false }, // Left edge of the dead zone, y is ignored
+    { "47900000", true, false, false, false },  // Just past it
+    { "99950011", false, true, true, true },    // All the way right
+    { "00050010", true, false, true, false },   // All the way left
+};
+
+// Decoding sample device controller messages. Returns the number decoded wrong.
+static int bench_controller() {
+    int failures = 0;
+    for (const struct ControllerCase &c : controller_cases) {
+        EVENTS events = {};
+        input_decode_controller(c.message, &events);
+        if (events.left_flag != c.left || events.right_flag != c.right || events.shoot_flag != c.shoot || events.thrust_flag != c.thrust) {
+            SDL_Log("[input] FAIL: controller message %s decoded as left %d right %d shoot %d thrust %d", c.message,
+                    events.left_flag, events.right_flag, events.shoot_flag, events.thrust_flag);
+            failures++;
+        }
+    }
+    SDL_Log("[input] %d of %d controller messages decoded correctly", (int)SDL_arraysize(controller_cases) - failures, (int)SDL_arraysize(controller_cases));
+    return failures;
+}
+
+// Recording, optimizing and replaying a busy frame, and checking game frames
+// against drawing them immediately. Returns the number of frames that differ.
+static int bench_display_list() {
+    static GameState<GameSim> state;
+    static GameState<GameSim> previous;
+    static Sint16 shapes[MAX_ASTEROIDS][ASTEROID_VERTICES][2];
+    static struct Arena arena;
+    Uint8 *pixels = (Uint8 *)SDL_aligned_alloc(64, (size_t)INDEX_PITCH * HEIGHT);
+    Uint8 *reference = (Uint8 *)SDL_aligned_alloc(64, (size_t)INDEX_PITCH * HEIGHT);
+    if (!pixels || !reference || !arena_init(&arena, FRAME_ARENA_SIZE)) {
+        SDL_aligned_free(pixels);
+        SDL_aligned_free(reference);
+        return 1;
+    }
+
+    init_asteroid_shapes(shapes);
+    sim_init(&state, 54321);
+    EVENTS key_events;
+    for (int tick = 0; tick < 3000; tick++) {
+        scripted_input(tick, true, &key_events);
+        sim_tick(&state, &key_events);
+    }
+
+    struct DisplayList list;
+    Uint64 start = SDL_GetTicksNS();
+    for (int i = 0; i < DISPLAY_LIST_ITERATIONS; i++) {
+        display_list_begin_immediate(&list, reference, INDEX_PITCH, WIDTH, HEIGHT);
+        draw_game_frame(&list, &state, NULL, shapes);
+    }
+    report("displaylist", "immediate", SDL_GetTicksNS() - start, DISPLAY_LIST_ITERATIONS);
+
+    Uint64 record_ns = 0, optimize_ns = 0;
+    for (int i = 0; i < DISPLAY_LIST_ITERATIONS; i++) {
+        arena_reset(&arena);
+        display_list_begin(&list, &arena, WIDTH, HEIGHT);
+        Uint64 t0 = SDL_GetTicksNS();
+        draw_game_frame(&list, &state, NULL, shapes);
+        Uint64 t1 = SDL_GetTicksNS();
+        display_list_optimize(&list);
+        optimize_ns += SDL_GetTicksNS() - t1;
+        record_ns += t1 - t0;
+    }
+    report("displaylist", "record", record_ns, DISPLAY_LIST_ITERATIONS);
+    report("displaylist", "optimize", optimize_ns, DISPLAY_LIST_ITERATIONS);
+
+    // The last recorded list replays the same frame every time
+    start = SDL_GetTicksNS();
+    for (int i = 0; i < DISPLAY_LIST_ITERATIONS; i++) {
+        display_list_execute(&list, pixels, INDEX_PITCH);
+    }
+    report("displaylist", "execute", SDL_GetTicksNS() - start, DISPLAY_LIST_ITERATIONS);
+
+    const struct DisplayListStats *stats = &list.stats;
+    SDL_Log("[displaylist] %d draw calls: %d culled, %d merged, %d overdrawn, %d dropped, %d executed (%d bullets)",
+            stats->recorded, stats->culled, stats->merged, stats->overdrawn, stats->dropped, list.count, state.bullet_count);
+
+    // Check frames all through a game, on their own and recorded over the previous one checked
+    int failures = 0;
+    struct DisplayListStats totals = {};
+    sim_init(&state, 54321);
+    previous = state;
+    for (int tick = 1; tick <= DISPLAY_LIST_CHECK_TICKS; tick++) {
+        scripted_input(tick, true, &key_events);
+        sim_tick(&state, &key_events);
+        if (tick % DISPLAY_LIST_CHECK_EVERY) {
+            continue;
+        }
+        for (int overdraw = 0; overdraw < 2; overdraw++) {
+            const GameState<GameSim> *under = overdraw ? &previous : NULL;
+            SDL_memset(reference, 0xFF, (size_t)INDEX_PITCH * HEIGHT);
+            display_list_begin_immediate(&list, reference, INDEX_PITCH, WIDTH, HEIGHT);
+            draw_game_frame(&list, &state, under, shapes);
+
+            arena_reset(&arena);
+            display_list_begin(&list, &arena, WIDTH, HEIGHT);
+            draw_game_frame(&list, &state, under, shapes);
+            display_list_optimize(&list);
+            SDL_memset(pixels, 0xFF, (size_t)INDEX_PITCH * HEIGHT);
+            display_list_execute(&list, pixels, INDEX_PITCH);
+
+            totals.recorded += stats->recorded;
+            totals.culled += stats->culled;
+            totals.merged += stats->merged;
+            totals.overdrawn += stats->overdrawn;
+            if (SDL_memcmp(pixels, reference, (size_t)INDEX_PITCH * HEIGHT) != 0) {
+                SDL_Log("[displaylist] FAIL: tick %d%s differs from immediate drawing", tick, overdraw ? " over the previous frame" : "");
+                failures++;
+            }
+        }
+        previous = state;
+    }
+    SDL_Log("[displaylist] %d frames checked against immediate drawing: %d draw calls, %d culled, %d merged, %d overdrawn",
+            2 * DISPLAY_LIST_CHECK_TICKS / DISPLAY_LIST_CHECK_EVERY, totals.recorded, totals.culled, totals.merged, totals.overdrawn);
+
+    arena_destroy(&arena);
+    SDL_aligned_free(pixels);
+    SDL_aligned_free(reference);
+    return failures;
+}
+
+// Reference rasterizers: the pixel rules from raster.h applied pixel by pixel,
+// with a bounds check on every pixel instead of clipping
+
+static inline void reference_plot(const struct RasterTarget *t, int x, int y, Uint8 color) {
+    if (x >= 0 && x < t->width && y >= 0 && y < t->height) {
+        t->pixels[y * t->pitch + x] = color;
+    }
+}
+
+// Plain Bresenham over the whole line. Stepping the minor axis when the error
+// is exactly zero rounds halves away from the start.
+static void reference_line(const struct RasterTarget *t, int x0, int y0, int x1, int y1, Uint8 color) {
+    int adx = SDL_abs(x1 - x0);
+    int ady = SDL_abs(y1 - y0);
+    int sx = x1 < x0 ? -1 : 1;
+    int sy = y1 < y0 ? -1 : 1;
+    int x = x0;
+    int y = y0;
+    if (adx >= ady) {
+        int error = 2 * ady - adx;
+        for (int i = 0; i <= adx; i++) {
+            reference_plot(t, x, y, color);
+            if (error >= 0) {
+                y += sy;
+                error -= 2 * adx;
+            }
+            error += 2 * ady;
+            x += sx;
+        }
+    } else {
+        int error = 2 * adx - ady;
+        for (int i = 0; i <= ady; i++) {
+            reference_plot(t, x, y, color);
+            if (error >= 0) {
+                x += sx;
+                error -= 2 * ady;
+            }
+            error += 2 * adx;
+            y += sy;
+        }
+    }
+}
+
+static void reference_polygon_outline(const struct RasterTarget *t, const struct RasterPoint *points, int count, Uint8 color) {
+    for (int i = 0; i < count; i++) {
+        const struct RasterPoint *a = &points[i];
+        const struct RasterPoint *b = &points[(i + 1) % count];
+        reference_line(t, a->x, a->y, b->x, b->y, color);
+    }
+}
+
+// Even-odd test of every pixel center against every edge, in doubled
+// coordinates so the centers are whole numbers
+static void reference_polygon_fill(const struct RasterTarget *t, const struct RasterPoint *points, int count, Uint8 color) {
+    for (int y = 0; y < t->height; y++) {
+        for (int x = 0; x < t->width; x++) {
+            Sint64 px = 2 * x + 1;
+            Sint64 py = 2 * y + 1;
+            bool inside = false;
+            for (int i = 0; i < count; i++) {
+                Sint64 ax = 2 * (Sint64)points[i].x;
+                Sint64 ay = 2 * (Sint64)points[i].y;
+                Sint64 bx = 2 * (Sint64)points[(i + 1) % count].x;
+                Sint64 by = 2 * (Sint64)points[(i + 1) % count].y;
+                // Only edges with one end above the center and the other at or below it
+                if ((ay < py) == (by < py)) {
+                    continue;
+                }
+                // Which side of the edge the center is on, facing from its upper end
+                Sint64 side = (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+                if (ay > by) {
+                    side = -side;
+                }
+                if (side <= 0) {
+                    inside = !inside;
+                }
+            }
+            if (inside) {
+                reference_plot(t, x, y, color);
+            }
+        }
+    }
+}
+
+static inline bool in_disc(int dx, int dy, int radius) {
+    return dx * dx + dy * dy <= radius * radius + radius;
+}
+
+static void reference_circle(const struct RasterTarget *t, int cx, int cy, int radius, Uint8 color, bool fill) {
+    for (int y = 0; y < t->height; y++) {
+        for (int x = 0; x < t->width; x++) {
+            int dx = x - cx;
+            int dy = y - cy;
+            if (!in_disc(dx, dy, radius)) {
+                continue;
+            }
+            bool edge = !in_disc(dx - 1, dy, radius) || !in_disc(dx + 1, dy, radius) ||
+                        !in_disc(dx, dy - 1, radius) || !in_disc(dx, dy + 1, radius);
+            if (fill || edge) {
+                reference_plot(t, x, y, color);
+            }
+        }
+    }
+}
+
+// Random shapes reaching up to a margin past every edge, so clipping gets exercised
+#define RASTER_MARGIN 40
+#define RASTER_POLYGON_POINTS 6
+
+struct RasterShape {
+    struct RasterPoint points[RASTER_POLYGON_POINTS];
+    int radius;
+    Uint8 color;
+};
+
+// Time `draw` over all the shapes, then check it against `reference` drawing the same.
+// Returns 1 if they differ.
+template <typename Draw, typename Reference>
+static int bench_primitive(const char *name, const struct RasterShape *shapes, int reference_count,
+                            const struct RasterTarget *fast, const struct RasterTarget *slow, Draw draw, Reference reference) {
+    SDL_memset(fast->pixels, 0, (size_t)fast->pitch * fast->height);
+    Uint64 start = SDL_GetTicksNS();
+    for (int i = 0; i < RASTER_SHAPES; i++) {
+        draw(fast, &shapes[i]);
+    }
+    report("raster", name, SDL_GetTicksNS() - start, RASTER_SHAPES);
+
+    // The per pixel references are slow, so compare on a smaller set
+    SDL_memset(fast->pixels, 0, (size_t)fast->pitch * fast->height);
+    SDL_memset(slow->pixels, 0, (size_t)slow->pitch * slow->height);
+    for (int i = 0; i < reference_count; i++) {
+        draw(fast, &shapes[i]);
+        reference(slow, &shapes[i]);
+    }
+    if (SDL_memcmp(fast->pixels, slow->pixels, (size_t)fast->pitch * fast->height) != 0) {
+        SDL_Log("[raster] %s: FAIL, differs from the reference rasterization", name);
+        return 1;
+    }
+    return 0;
+}
+
+// Shapes picked to cross each edge and corner of the screen, or lie far outside it
+#define RASTER_GUARD 8 // Pixels around the target that nothing may touch
+#define RASTER_GUARD_VALUE 0xEE
+
+struct RasterCase {
+    int count; // Points used, for lines the first two
+    struct RasterPoint points[RASTER_POLYGON_POINTS];
+};
+
+static const struct RasterCase raster_line_cases[] = {
+    { 2, { { -50, 20 }, { WIDTH + 50, 30 } } },                  // Through both sides
+    { 2, { { 20, -50 }, { 40, HEIGHT + 50 } } },                 // Steep, through top and bottom
+    { 2, { { -100, -100 }, { WIDTH + 100, HEIGHT + 100 } } },    // Out through opposite corners
+    { 2, { { -10, HEIGHT + 5 }, { 30, HEIGHT - 20 } } },         // In from below the bottom left
+    { 2, { { WIDTH - 1, HEIGHT - 1 }, { WIDTH + 5, HEIGHT + 9 } } }, // Leaving from the last pixel
+    { 2, { { WIDTH - 1, -20000 }, { WIDTH - 1, 20000 } } },      // Along the last column
+    { 2, { { -30000, 5 }, { 30000, 6 } } },                      // Far beyond both sides
+    { 2, { { -20, -5 }, { -1, 100 } } },                         // Entirely left of the screen
+    { 2, { { 5, -60 }, { -40, 30 } } },                          // Passing outside the top left corner
+};
+
+static const struct RasterCase raster_polygon_cases[] = {
+    { 3, { { -20, 10 }, { 30, 40 }, { -10, 80 } } },                              // Half off the left
+    { 3, { { WIDTH - 20, -15 }, { WIDTH + 25, 10 }, { WIDTH - 5, 30 } } },        // Over the top right corner
+    { 4, { { -50, -50 }, { WIDTH + 50, -50 }, { WIDTH + 50, HEIGHT + 50 }, { -50, HEIGHT + 50 } } }, // Bigger than the screen
+    { 6, { { 60, HEIGHT - 30 }, { 100, HEIGHT + 40 }, { 80, HEIGHT - 5 }, { 40, HEIGHT + 60 }, { 30, HEIGHT - 10 }, { 10, HEIGHT - 40 } } }, // Concave, through the bottom
+    { 5, { { -30, 20 }, { WIDTH + 30, 25 }, { WIDTH / 2, 60 }, { WIDTH + 30, 100 }, { -30, 110 } } }, // Across the screen both ways
+    { 3, { { -40, -40 }, { -10, -30 }, { -20, -5 } } },                           // Entirely outside
+    { 3, { { -1000, HEIGHT / 2 }, { WIDTH + 1000, HEIGHT / 2 - 3 }, { WIDTH / 2, HEIGHT + 1000 } } }, // Far beyond three edges
+};
+
+static const struct RasterCase raster_circle_cases[] = {
+    // Center and, in x of the second point, radius
+    { 1, { { 0, HEIGHT / 2 }, { 20, 0 } } },             // On the left edge
+    { 1, { { WIDTH, 10 }, { 25, 0 } } },                 // Over the top right corner
+    { 1, { { WIDTH / 2, HEIGHT + 5 }, { 12, 0 } } },     // Mostly below the bottom
+    { 1, { { WIDTH / 2, HEIGHT / 2 }, { 400, 0 } } },    // Bigger than the screen
+    { 1, { { -30, 50 }, { 30, 0 } } },                   // Touching the left edge from outside
+    { 1, { { -31, 50 }, { 30, 0 } } },                   // Just outside the left edge
+    { 1, { { WIDTH - 1, HEIGHT - 1 }, { 0, 0 } } },      // A single pixel in the corner
+};
+
+// Draw one case with `draw` and `reference` into targets surrounded by a guard
+// band, and check they match and the band is untouched. Returns 1 if not.
+template <typename Draw, typename Reference>
+static int check_raster_case(const char *name, int index, const struct RasterCase *c, Uint8 *fast_pixels, Uint8 *slow_pixels, Draw draw, Reference reference) {
+    const int pitch = WIDTH + 2 * RASTER_GUARD;
+    const size_t size = (size_t)pitch * (HEIGHT + 2 * RASTER_GUARD);
+    const int origin = RASTER_GUARD * pitch + RASTER_GUARD;
+    const struct RasterTarget fast = { fast_pixels + origin, pitch, WIDTH, HEIGHT };
+    const struct RasterTarget slow = { slow_pixels + origin, pitch, WIDTH, HEIGHT };
+    SDL_memset(fast_pixels, RASTER_GUARD_VALUE, size);
+    SDL_memset(slow_pixels, RASTER_GUARD_VALUE, size);
+    for (int y = 0; y < HEIGHT; y++) {
+        SDL_memset(fast.pixels + y * pitch, 0, WIDTH);
+        SDL_memset(slow.pixels + y * pitch, 0, WIDTH);
+    }
+    draw(&fast, c);
+    reference(&slow, c);
+    if (SDL_memcmp(fast_pixels, slow_pixels, size) != 0) {
+        SDL_Log("[raster] %s clipping case %d: FAIL, differs from the reference or draws outside the target", name, index);
+        return 1;
+    }
+    return 0;
+}
+
+// Every clipping case through the primitives it applies to. Returns the number that failed.
+static int check_raster_clipping() {
+    const size_t size = (size_t)(WIDTH + 2 * RASTER_GUARD) * (HEIGHT + 2 * RASTER_GUARD);
+    Uint8 *fast_pixels = (Uint8 *)SDL_malloc(size);
+    Uint8 *slow_pixels = (Uint8 *)SDL_malloc(size);
+    if (!fast_pixels || !slow_pixels) {
+        SDL_free(fast_pixels);
+        SDL_free(slow_pixels);
+        return 1;
+    }
+
+    int failures = 0;
+    int checked = 0;
+    for (int i = 0; i < (int)SDL_arraysize(raster_line_cases); i++, checked++) {
+        failures += check_raster_case("line", i, &raster_line_cases[i], fast_pixels, slow_pixels,
+            [](const struct RasterTarget *t, const struct RasterCase *c) {
+                raster_line(t, c->points[0].x, c->points[0].y, c->points[1].x, c->points[1].y, 3);
+            },
+            [](const struct RasterTarget *t, const struct RasterCase *c) {
+                reference_line(t, c->points[0].x, c->points[0].y, c->points[1].x, c->points[1].y, 3);
+            });
+    }
+    for (int i = 0; i < (int)SDL_arraysize(raster_polygon_cases); i++, checked += 2) {
+        failures += check_raster_case("polygon outline", i, &raster_polygon_cases[i], fast_pixels, slow_pixels,
+            [](const struct RasterTarget *t, const struct RasterCase *c) {
+                raster_polygon_outline(t, c->points, c->count, 4);
+            },
+            [](const struct RasterTarget *t, const struct RasterCase *c) {
+                reference_polygon_outline(t, c->points, c->count, 4);
+            });
+        failures += check_raster_case("polygon fill", i, &raster_polygon_cases[i], fast_pixels, slow_pixels,
+            [](const struct RasterTarget *t, const struct RasterCase *c) {
+                raster_polygon_fill(t, c->points, c->count, 5);
+            },
+            [](const struct RasterTarget *t, const struct RasterCase *c) {
+                reference_polygon_fill(t, c->points, c->count, 5);
+            });
+    }
+    for (int i = 0; i < (int)SDL_arraysize(raster_circle_cases); i++, checked += 2) {
+        failures += check_raster_case("circle outline", i, &raster_circle_cases[i], fast_pixels, slow_pixels,
+            [](const struct RasterTarget *t, const struct RasterCase *c) {
+                raster_circle_outline(t, c->points[0].x, c->points[0].y, c->points[1].x, 6);
+            },
+            [](const struct RasterTarget *t, const struct RasterCase *c) {
+                reference_circle(t, c->points[0].x, c->points[0].y, c->points[1].x, 6, false);
+            });
+        failures += check_raster_case("circle fill", i, &raster_circle_cases[i], fast_pixels, slow_pixels,
+            [](const struct RasterTarget *t, const struct RasterCase *c) {
+                raster_circle_fill(t, c->points[0].x, c->points[0].y, c->points[1].x, 7);
+            },
+            [](const struct RasterTarget *t, const struct RasterCase *c) {
+                reference_circle(t, c->points[0].x, c->points[0].y, c->points[1].x, 7, true);
+            });
+    }
+    SDL_Log("[raster] %d of %d clipping cases match the reference", checked - failures, checked);
+
+    SDL_free(fast_pixels);
+    SDL_free(slow_pixels);
+    return failures;
+}
+
+// The line clipping cases recorded into a display list and executed, against
+// drawing them immediately. Returns the number that differ.
+static int check_display_list_lines() {
+    static struct Arena arena;
+    Uint8 *pixels = (Uint8 *)SDL_aligned_alloc(64, (size_t)INDEX_PITCH * HEIGHT);
+    Uint8 *reference = (Uint8 *)SDL_aligned_alloc(64, (size_t)INDEX_PITCH * HEIGHT);
+    if (!pixels || !reference || !arena_init(&arena, FRAME_ARENA_SIZE)) {
+        SDL_aligned_free(pixels);
+        SDL_aligned_free(reference);
+        return 1;
+    }
+
+    int failures = 0;
+    struct DisplayList list;
+    for (int i = 0; i < (int)SDL_arraysize(raster_line_cases); i++) {
+        const struct RasterPoint *p = raster_line_cases[i].points;
+        SDL_memset(pixels, 0, (size_t)INDEX_PITCH * HEIGHT);
+        SDL_memset(reference, 0, (size_t)INDEX_PITCH * HEIGHT);
+        arena_reset(&arena);
+        display_list_begin(&list, &arena, WIDTH, HEIGHT);
+        display_list_line(&list, p[0].x, p[0].y, p[1].x, p[1].y, 3);
+        display_list_execute(&list, pixels, INDEX_PITCH);
+        display_list_begin_immediate(&list, reference, INDEX_PITCH, WIDTH, HEIGHT);
+        display_list_line(&list, p[0].x, p[0].y, p[1].x, p[1].y, 3);
+        if (SDL_memcmp(pixels, reference, (size_t)INDEX_PITCH * HEIGHT) != 0) {
+            SDL_Log("[displaylist] FAIL: line clipping case %d differs from immediate drawing", i);
+            failures++;
+        }
+    }
+    SDL_Log("[displaylist] %d of %d line clipping cases match immediate drawing",
+            (int)SDL_arraysize(raster_line_cases) - failures, (int)SDL_arraysize(raster_line_cases));
+
+    arena_destroy(&arena);
+    SDL_aligned_free(pixels);
+    SDL_aligned_free(reference);
+    return failures;
+}
+
+// Returns the number of checks that failed
+static int bench_raster() {
+    static struct RasterShape shapes[RASTER_SHAPES];
+    Uint8 *fast_pixels = (Uint8 *)SDL_aligned_alloc(64, (size_t)INDEX_PITCH * HEIGHT);
+    Uint8 *slow_pixels = (Uint8 *)SDL_aligned_alloc(64, (size_t)INDEX_PITCH * HEIGHT);
+    if (!fast_pixels || !slow_pixels) {
+        SDL_aligned_free(fast_pixels);
+        SDL_aligned_free(slow_pixels);
+        return 1;
+    }
+    const struct RasterTarget fast = { fast_pixels, INDEX_PITCH, WIDTH, HEIGHT };
+    const struct RasterTarget slow = { slow_pixels, INDEX_PITCH, WIDTH, HEIGHT };
+
+    // Shapes up to about asteroid size, and lines of any length
+    unsigned long rng = 99;
+    for (int i = 0; i < RASTER_SHAPES; i++) {
+        struct RasterShape *shape = &shapes[i];
+        int cx = random_range(&rng, -RASTER_MARGIN, WIDTH + RASTER_MARGIN);
+        int cy = random_range(&rng, -RASTER_MARGIN, HEIGHT + RASTER_MARGIN);
+        for (int p = 0; p < RASTER_POLYGON_POINTS; p++) {
+            shape->points[p].x = cx + random_range(&rng, -30, 30);
+            shape->points[p].y = cy + random_range(&rng, -30, 30);
+        }
+        shape->radius = random_range(&rng, 0, 30);
+        shape->color = 1 + i % (PALETTE_SIZE - 1);
+    }
+    const int reference_count = 200;
+    // The guarded clipping cases go first, so drawing outside the target is reported before it can corrupt the heap
+    int failures = check_raster_clipping();
+
+    failures += bench_primitive("line", shapes, RASTER_SHAPES, &fast, &slow,
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            raster_line(t, s->points[0].x * 3 - WIDTH, s->points[0].y, s->points[1].x, s->points[1].y * 3 - HEIGHT, s->color);
+        },
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            reference_line(t, s->points[0].x * 3 - WIDTH, s->points[0].y, s->points[1].x, s->points[1].y * 3 - HEIGHT, s->color);
+        });
+    failures += bench_primitive("triangle outline", shapes, RASTER_SHAPES, &fast, &slow,
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            raster_triangle_outline(t, s->points[0], s->points[1], s->points[2], s->color);
+        },
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            reference_polygon_outline(t, s->points, 3, s->color);
+        });
+    failures += bench_primitive("triangle fill", shapes, reference_count, &fast, &slow,
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            raster_triangle_fill(t, s->points[0], s->points[1], s->points[2], s->color);
+        },
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            reference_polygon_fill(t, s->points, 3, s->color);
+        });
+    failures += bench_primitive("polygon outline", shapes, RASTER_SHAPES, &fast, &slow,
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            raster_polygon_outline(t, s->points, RASTER_POLYGON_POINTS, s->color);
+        },
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            reference_polygon_outline(t, s->points, RASTER_POLYGON_POINTS, s->color);
+        });
+    failures += bench_primitive("polygon fill", shapes, reference_count, &fast, &slow,
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            raster_polygon_fill(t, s->points, RASTER_POLYGON_POINTS, s->color);
+        },
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            reference_polygon_fill(t, s->points, RASTER_POLYGON_POINTS, s->color);
+        });
+    failures += bench_primitive("circle outline", shapes, reference_count, &fast, &slow,
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            raster_circle_outline(t, s->points[0].x, s->points[0].y, s->radius, s->color);
+        },
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            reference_circle(t, s->points[0].x, s->points[0].y, s->radius, s->color, false);
+        });
+    failures += bench_primitive("circle fill", shapes, reference_count, &fast, &slow,
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            raster_circle_fill(t, s->points[0].x, s->points[0].y, s->radius, s->color);
+        },
+        [](const struct RasterTarget *t, const struct RasterShape *s) {
+            reference_circle(t, s->points[0].x, s->points[0].y, s->radius, s->color, true);
+        });
+
+    SDL_aligned_free(fast_pixels);
+    SDL_aligned_free(slow_pixels);
+    return failures;
+}
+
+int run_benchmarks() {
+    // The simulation reports hits and shots, which only matter for the real game
+    eventlog_set_muted(true);
+    int failures = 0;
+
+    if (bench_enabled("upscale")) {
+        failures += bench_upscale();
+    }
+    if (bench_enabled("input")) {
+        failures += bench_controller();
+    }
+    if (bench_enabled("sim")) {
+        bench_sim_ticks<FloatSim>("float");
+        bench_sim_ticks<FixedSim>("fixed");
+        failures += bench_sim_drift();
+    }
+    if (bench_enabled("snapshot")) {
+        bench_snapshot();
+        failures += check_rewind_telemetry();
+    }
+    if (bench_enabled("rollback")) {
+        failures += bench_rollback();
+    }
+    if (bench_enabled("particles")) {
+        bench_particles();
+    }
+    if (bench_enabled("palette")) {
+        failures += bench_palette();
+    }
+    if (bench_enabled("displaylist")) {
+        failures += bench_display_list();
+        failures += check_display_list_lines();
+    }
+    if (bench_enabled("raster")) {
+        failures += bench_raster();
+    }
+
+    eventlog_set_muted(false);
+    if (failures) {
+        SDL_Log("%d check%s FAILED", failures, failures == 1 ? "" : "s");
+    }
+    return failures;
+}
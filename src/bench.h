@@ -0,0 +1,9 @@
+#pragma once
+
+// Benchmarks run instead of the game when ASTEROIDS_BENCH is set.
+// ASTEROIDS_BENCH=all runs everything, otherwise it is a comma separated
+// list of benchmark names (e.g. ASTEROIDS_BENCH=upscale).
+// Benchmarks that check their results count what fails, and the process
+// exits with an error when anything did.
+bool bench_requested();
+int run_benchmarks();
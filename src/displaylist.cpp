@@ -0,0 +1,240 @@
+#include "displaylist.h"
+#include "raster.h"
+
+bool display_list_begin(struct DisplayList *list, struct Arena *arena, int width, int height) {
+    SDL_memset(list, 0, sizeof(*list));
+    list->width = width;
+    list->height = height;
+    list->commands = arena_alloc_array<struct DrawCommand>(arena, DISPLAY_LIST_CAPACITY);
+    if (!list->commands) {
+        return false;
+    }
+    list->capacity = DISPLAY_LIST_CAPACITY;
+    return true;
+}
+
+void display_list_begin_immediate(struct DisplayList *list, Uint8 *pixels, int pitch, int width, int height) {
+    SDL_memset(list, 0, sizeof(*list));
+    list->width = width;
+    list->height = height;
+    list->immediate = pixels;
+    list->immediate_pitch = pitch;
+}
+
+void display_list_rect(struct DisplayList *list, int x, int y, int w, int h, Uint8 color) {
+    list->stats.recorded++;
+
+    // Clip to the screen once here, so executing never has to
+    int start_x = SDL_max(x, 0);
+    int start_y = SDL_max(y, 0);
+    int end_x = SDL_min(x + w, list->width);
+    int end_y = SDL_min(y + h, list->height);
+    if (start_x >= end_x || start_y >= end_y) {
+        list->stats.culled++;
+        return;
+    }
+    w = end_x - start_x;
+    h = end_y - start_y;
+
+    if (list->immediate) {
+        Uint8 *row = list->immediate + start_y * list->immediate_pitch + start_x;
+        for (int j = 0; j < h; j++) {
+            SDL_memset(row, color, w);
+            row += list->immediate_pitch;
+        }
+        return;
+    }
+
+    // Text and ship outlines come as runs of small rects, join them when they line up
+    if (list->count > 0) {
+        struct DrawCommand *last = &list->commands[list->count - 1];
+        if (last->type == DRAW_RECT && last->color == color) {
+            if (last->y == start_y && last->h == h && last->x + last->w == start_x) {
+                last->w += w;
+                list->stats.merged++;
+                return;
+            }
+            if (last->x == start_x && last->w == w && last->y + last->h == start_y) {
+                last->h += h;
+                list->stats.merged++;
+                return;
+            }
+        }
+    }
+
+    if (list->count == list->capacity) {
+        list->stats.dropped++;
+        return;
+    }
+    struct DrawCommand *cmd = &list->commands[list->count++];
+    cmd->x = start_x;
+    cmd->y = start_y;
+    cmd->w = w;
+    cmd->h = h;
+    cmd->color = color;
+    cmd->type = DRAW_RECT;
+}
+
+// Cut the line from (x0, y0) to (x1, y1) down to the part within `limit` of
+// the origin on both axes (Liang-Barsky). Returns false if none of it is.
+static bool limit_line(int *x0, int *y0, int *x1, int *y1, int limit) {
+    double dx = (double)*x1 - *x0;
+    double dy = (double)*y1 - *y0;
+    // Each edge as p * t <= q, for the line at x0 + t * dx, y0 + t * dy
+    const double p[4] = { -dx, dx, -dy, dy };
+    const double q[4] = { (double)*x0 + limit, (double)limit - *x0, (double)*y0 + limit, (double)limit - *y0 };
+    double t0 = 0;
+    double t1 = 1;
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0) {
+            if (q[i] < 0) {
+                return false;
+            }
+        } else if (p[i] < 0) {
+            t0 = SDL_max(t0, q[i] / p[i]);
+        } else {
+            t1 = SDL_min(t1, q[i] / p[i]);
+        }
+    }
+    if (t0 > t1) {
+        return false;
+    }
+    int sx = *x0;
+    int sy = *y0;
+    *x0 = SDL_clamp((int)SDL_lround(sx + t0 * dx), -limit, limit);
+    *y0 = SDL_clamp((int)SDL_lround(sy + t0 * dy), -limit, limit);
+    *x1 = SDL_clamp((int)SDL_lround(sx + t1 * dx), -limit, limit);
+    *y1 = SDL_clamp((int)SDL_lround(sy + t1 * dy), -limit, limit);
+    return true;
+}
+
+void display_list_line(struct DisplayList *list, int x0, int y0, int x1, int y1, Uint8 color) {
+    list->stats.recorded++;
+
+    if (list->immediate) {
+        const struct RasterTarget target = { list->immediate, list->immediate_pitch, list->width, list->height };
+        raster_line(&target, x0, y0, x1, y1, color);
+        return;
+    }
+
+    // Lines wholly beyond one edge are culled, the rest are clipped by raster_line
+    if ((x0 < 0 && x1 < 0) || (y0 < 0 && y1 < 0) ||
+        (x0 >= list->width && x1 >= list->width) || (y0 >= list->height && y1 >= list->height)) {
+        list->stats.culled++;
+        return;
+    }
+
+    // Far off the screen, only where the line goes matters, not where it ends
+    const int limit = DISPLAY_LIST_COORD_LIMIT;
+    if (SDL_abs(x0) > limit || SDL_abs(y0) > limit || SDL_abs(x1) > limit || SDL_abs(y1) > limit) {
+        if (!limit_line(&x0, &y0, &x1, &y1, limit)) {
+            list->stats.culled++;
+            return;
+        }
+    }
+
+    if (list->count == list->capacity) {
+        list->stats.dropped++;
+        return;
+    }
+    struct DrawCommand *cmd = &list->commands[list->count++];
+    cmd->x = x0;
+    cmd->y = y0;
+    cmd->w = x1 - x0;
+    cmd->h = y1 - y0;
+    cmd->color = color;
+    cmd->type = DRAW_LINE;
+}
+
+// Bounding box of the pixels a command may touch
+static inline void command_bounds(const struct DrawCommand *cmd, int *x0, int *y0, int *x1, int *y1) {
+    if (cmd->type == DRAW_RECT) {
+        *x0 = cmd->x;
+        *y0 = cmd->y;
+        *x1 = cmd->x + cmd->w;
+        *y1 = cmd->y + cmd->h;
+    } else {
+        *x0 = SDL_min(cmd->x, cmd->x + cmd->w);
+        *y0 = SDL_min(cmd->y, cmd->y + cmd->h);
+        *x1 = SDL_max(cmd->x, cmd->x + cmd->w) + 1;
+        *y1 = SDL_max(cmd->y, cmd->y + cmd->h) + 1;
+    }
+}
+
+static inline bool rect_contains(const struct DrawCommand *outer, const struct DrawCommand *inner) {
+    int x0, y0, x1, y1;
+    command_bounds(inner, &x0, &y0, &x1, &y1);
+    return x0 >= outer->x && y0 >= outer->y && x1 <= outer->x + outer->w && y1 <= outer->y + outer->h;
+}
+
+void display_list_optimize(struct DisplayList *list) {
+    // Walk backwards, remembering the biggest rects drawn later. Everything is
+    // opaque, so a command inside one of them would never be seen.
+    struct DrawCommand occluders[DISPLAY_LIST_OCCLUDERS];
+    int occluder_count = 0;
+    int smallest = 0; // Index of the smallest occluder, replaced first
+    int removed = 0;
+
+    for (int i = list->count - 1; i >= 0; i--) {
+        struct DrawCommand *cmd = &list->commands[i];
+        bool hidden = false;
+        for (int j = 0; j < occluder_count; j++) {
+            if (rect_contains(&occluders[j], cmd)) {
+                hidden = true;
+                break;
+            }
+        }
+        if (hidden) {
+            // Recorded rects are never empty, so turning it into an empty one marks it for removal
+            cmd->type = DRAW_RECT;
+            cmd->w = 0;
+            removed++;
+            continue;
+        }
+
+        // Only rects hide what is under them
+        int area = cmd->w * cmd->h;
+        if (cmd->type != DRAW_RECT || area < DISPLAY_LIST_OCCLUDER_AREA) {
+            continue;
+        }
+        if (occluder_count < DISPLAY_LIST_OCCLUDERS) {
+            occluders[occluder_count++] = *cmd;
+        } else if (area > occluders[smallest].w * occluders[smallest].h) {
+            occluders[smallest] = *cmd;
+        } else {
+            continue;
+        }
+        for (int j = 0; j < occluder_count; j++) {
+            if (occluders[j].w * occluders[j].h < occluders[smallest].w * occluders[smallest].h) {
+                smallest = j;
+            }
+        }
+    }
+
+    if (removed) {
+        int kept = 0;
+        for (int i = 0; i < list->count; i++) {
+            if (list->commands[i].type != DRAW_RECT || list->commands[i].w) {
+                list->commands[kept++] = list->commands[i];
+            }
+        }
+        list->count = kept;
+        list->stats.overdrawn += removed;
+    }
+}
+
+void display_list_execute(const struct DisplayList *list, Uint8 *pixels, int pitch) {
+    const struct RasterTarget target = { pixels, pitch, list->width, list->height };
+    for (int i = 0; i < list->count; i++) {
+        const struct DrawCommand *cmd = &list->commands[i];
+        if (cmd->type == DRAW_LINE) {
+            raster_line(&target, cmd->x, cmd->y, cmd->x + cmd->w, cmd->y + cmd->h, cmd->color);
+            continue;
+        }
+        Uint8 *row = pixels + cmd->y * pitch + cmd->x;
+        for (int j = 0; j < cmd->h; j++) {
+            SDL_memset(row, cmd->color, cmd->w);
+            row += pitch;
+        }
+    }
+}
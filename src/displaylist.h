@@ -0,0 +1,79 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include "arena.h"
+
+// Display list renderer.
+// Draw calls only record a command. Recording drops anything off the screen,
+// and merges a rect into the previous one when they are the same color and
+// line up. Before executing, display_list_optimize() removes commands that
+// something later completely paints over. The list is plain data, so a
+// recorded frame can be executed again (e.g. by benchmarks).
+
+// Commands per frame. More than that are dropped (and counted).
+#ifndef DISPLAY_LIST_CAPACITY
+#define DISPLAY_LIST_CAPACITY 4096
+#endif
+
+// Rects at least this big are remembered as occluders when looking for overdraw
+#define DISPLAY_LIST_OCCLUDER_AREA 64
+// How many occluders are remembered at once
+#define DISPLAY_LIST_OCCLUDERS 16
+// Lines reaching further than this from the origin are cut short when they
+// are recorded, so their end points and lengths fit in a DrawCommand
+#define DISPLAY_LIST_COORD_LIMIT 16383
+
+enum DrawCommandType : Uint8 {
+    DRAW_RECT, // Filled rect, already clipped to the screen
+    DRAW_LINE, // Line from (x, y) to (x + w, y + h), clipped when it is drawn (see raster.h)
+};
+
+// One palette index drawn as a rect or a line
+struct DrawCommand {
+    Sint16 x;
+    Sint16 y;
+    Sint16 w;
+    Sint16 h;
+    Uint8 color;
+    DrawCommandType type;
+};
+
+struct DisplayListStats {
+    int recorded; // Draw calls made
+    int culled;   // Completely off screen
+    int merged;   // Folded into the previous command
+    int overdrawn; // Removed because a later command covers them
+    int dropped;  // Didn't fit in the list
+};
+
+struct DisplayList {
+    struct DrawCommand *commands;
+    int count;
+    int capacity;
+    int width;
+    int height;
+    struct DisplayListStats stats;
+    // Set by display_list_begin_immediate(), draw calls go straight into these pixels
+    Uint8 *immediate;
+    int immediate_pitch;
+};
+
+// Start an empty list for a width x height screen, with its commands in `arena`.
+// Returns false if the arena has no room for them.
+bool display_list_begin(struct DisplayList *list, struct Arena *arena, int width, int height);
+
+// Start a list that draws every call into `pixels` straight away, without
+// merging or optimizing anything. Benchmarks check recorded lists against it.
+void display_list_begin_immediate(struct DisplayList *list, Uint8 *pixels, int pitch, int width, int height);
+
+// Record a filled rect
+void display_list_rect(struct DisplayList *list, int x, int y, int w, int h, Uint8 color);
+
+// Record a line, both end points included
+void display_list_line(struct DisplayList *list, int x0, int y0, int x1, int y1, Uint8 color);
+
+// Remove commands that are painted over completely by later ones
+void display_list_optimize(struct DisplayList *list);
+
+// Draw the commands into a buffer of palette indices
+void display_list_execute(const struct DisplayList *list, Uint8 *pixels, int pitch);
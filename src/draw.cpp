@@ -0,0 +1,260 @@
+#include "draw.h"
+
+// Drawing is recorded into the frame's display list and done all at once later (see displaylist.h)
+void draw_rect(struct DisplayList *list, int x, int y, int w, int h, Uint8 color) {
+    display_list_rect(list, x, y, w, h, color);
+}
+
+// Function to draw a line, including both end points
+void draw_line(struct DisplayList *list, int x0, int y0, int x1, int y1, Uint8 color) {
+    display_list_line(list, x0, y0, x1, y1, color);
+}
+
+// Function to make up the asteroid outlines
+void init_asteroid_shapes(Sint16 shapes[MAX_ASTEROIDS][ASTEROID_VERTICES][2]) {
+    unsigned long seed = 777;
+    for (int i = 0; i < MAX_ASTEROIDS; i++) {
+        for (int v = 0; v < ASTEROID_VERTICES; v++) {
+            float angle = 2.0f * SDL_PI_F * v / ASTEROID_VERTICES;
+            float radius = random_range(&seed, 190, 300);
+            shapes[i][v][0] = (Sint16)(SDL_sinf(angle) * radius);
+            shapes[i][v][1] = (Sint16)(-SDL_cosf(angle) * radius);
+        }
+    }
+}
+
+// Function to draw an asteroid
+void draw_asteroid(struct DisplayList *list, const AsteroidT<GameSim> *myAsteroid, const Sint16 shape[ASTEROID_VERTICES][2]) {
+    // Convert position to int for drawing, the outline goes around the middle of its box
+    int radius = myAsteroid->width / 2 + 1;
+    int center_x = (int)myAsteroid->x + myAsteroid->width / 2;
+    int center_y = (int)myAsteroid->y + myAsteroid->height / 2;
+
+    for (int v = 0; v < ASTEROID_VERTICES; v++) {
+        int next = (v + 1) % ASTEROID_VERTICES;
+        draw_line(list, center_x + shape[v][0] * radius / 256, center_y + shape[v][1] * radius / 256,
+                  center_x + shape[next][0] * radius / 256, center_y + shape[next][1] * radius / 256, PAL_ASTEROID);
+    }
+}
+
+// Function to draw the bullets that are still alive
+void draw_bullets(struct DisplayList *list, const GameState<GameSim> *state) {
+    for (int i = 0; i < state->bullet_count; i++) {
+        if (!state->bullets[i].active) continue;
+
+        // Draw the bullet (yellow)
+        int draw_x = (int)state->bullets[i].x;
+        int draw_y = (int)state->bullets[i].y;
+        draw_rect(list, draw_x, draw_y, 2, 2, PAL_BULLET);
+    }
+}
+
+// Function to draw a player (ship-shaped)
+void draw_player(struct DisplayList *list, GameSim::Position x, GameSim::Position y, GameSim::Scalar rotation) {
+    typedef GameSim::Scalar Scalar;
+
+    // Convert position to int for drawing
+    int draw_x = (int)x;
+    int draw_y = (int)y;
+    
+    // Calculate rotated points for the ship triangle
+    // Ship is a triangle pointing up
+    const Scalar size = Scalar(8); // Size of the ship
+    const Scalar back = Scalar(150); // Angle of the back corners
+    int points[3][2];
+    
+    // Calculate the three points of the triangle
+    // Front point (nose)
+    points[0][0] = draw_x + (int)(size * sim_sin_deg(rotation));
+    points[0][1] = draw_y - (int)(size * sim_cos_deg(rotation));
+    
+    // Back left point
+    points[1][0] = draw_x + (int)(size * sim_sin_deg(rotation + back)); // 150 degrees
+    points[1][1] = draw_y - (int)(size * sim_cos_deg(rotation + back));
+    
+    // Back right point
+    points[2][0] = draw_x + (int)(size * sim_sin_deg(rotation - back)); // -150 degrees
+    points[2][1] = draw_y - (int)(size * sim_cos_deg(rotation - back));
+    
+    // Draw the ship triangle
+    for (int i = 0; i < 3; i++) {
+        int next = (i + 1) % 3;
+        draw_line(list, points[i][0], points[i][1], points[next][0], points[next][1], PAL_SHIP);
+    }
+}
+
+// Function to draw a simple character using rectangles
+void draw_char(struct DisplayList *list, int x, int y, char c, Uint8 color) {
+    // Simple 5x7 pixel font for ASCII characters
+    // This is a very basic implementation that only handles a few characters
+    // For a full implementation, you would need a complete font bitmap
+    
+    switch (c) {
+        case '0':
+            draw_rect(list, x, y, 5, 1, color);
+            draw_rect(list, x, y, 1, 7, color);
+            draw_rect(list, x+4, y, 1, 7, color);
+            draw_rect(list, x, y+6, 5, 1, color);
+            break;
+        case '1':
+            draw_rect(list, x+2, y, 1, 7, color);
+            // draw_rect(list, x+1, y+1, 3, 1, color);
+            break;
+        case '2':
+            draw_rect(list, x, y, 5, 1, color);      // Top horizontal
+            draw_rect(list, x+4, y+1, 1, 2, color);  // Right vertical at top
+            draw_rect(list, x, y+3, 5, 1, color);    // Middle horizontal
+            draw_rect(list, x, y+4, 1, 2, color);    // Left vertical at bottom
+            draw_rect(list, x, y+6, 5, 1, color);    // Bottom horizontal
+            break;
+        case '3':
+            draw_rect(list, x, y, 5, 1, color);
+            draw_rect(list, x+4, y+1, 1, 5, color);
+            draw_rect(list, x, y+6, 5, 1, color);
+            draw_rect(list, x, y+3, 5, 1, color);
+            break;
+        case '4':
+            draw_rect(list, x, y, 1, 4, color);      // Left vertical line (top portion)
+            draw_rect(list, x+4, y, 1, 7, color);    // Right vertical line (full height)
+            draw_rect(list, x, y+3, 5, 1, color);    // Middle horizontal line
+            break;
+        case '5':
+            draw_rect(list, x, y, 5, 1, color);
+            draw_rect(list, x, y+1, 1, 2, color);
+            draw_rect(list, x, y+3, 5, 1, color);
+            draw_rect(list, x+4, y+4, 1, 2, color);
+            draw_rect(list, x, y+6, 5, 1, color);
+            break;
+        case '6':
+            draw_rect(list, x, y, 5, 1, color);
+            draw_rect(list, x, y+1, 1, 5, color);
+            draw_rect(list, x, y+3, 5, 1, color);
+            draw_rect(list, x+4, y+4, 1, 2, color);
+            draw_rect(list, x, y+6, 5, 1, color);
+            break;
+        case '7':
+            draw_rect(list, x, y, 5, 1, color);
+            draw_rect(list, x+4, y+1, 1, 5, color);
+            break;
+        case '8':
+            draw_rect(list, x, y, 5, 1, color);
+            draw_rect(list, x, y+1, 1, 5, color);
+            draw_rect(list, x+4, y+1, 1, 5, color);
+            draw_rect(list, x, y+3, 5, 1, color);
+            draw_rect(list, x, y+6, 5, 1, color);
+            break;
+        case '9':
+            draw_rect(list, x, y, 5, 1, color);
+            draw_rect(list, x, y+1, 1, 2, color);
+            draw_rect(list, x+4, y+1, 1, 5, color);
+            draw_rect(list, x, y+3, 5, 1, color);
+            draw_rect(list, x, y+6, 5, 1, color);
+            break;
+    case 'S':
+        draw_rect(list, x, y, 5, 1, color);      // Top horizontal
+        draw_rect(list, x, y+1, 1, 2, color);    // Left vertical (top portion)
+        draw_rect(list, x, y+3, 5, 1, color);    // Middle horizontal
+        draw_rect(list, x+4, y+4, 1, 2, color);  // Right vertical (bottom portion)
+        draw_rect(list, x, y+6, 5, 1, color);    // Bottom horizontal
+        break;
+
+    case 'c':
+        // Current implementation shows a full box, but lowercase 'c' should be open on the right top
+        draw_rect(list, x+1, y, 4, 1, color);    // Top horizontal (slightly indented)
+        draw_rect(list, x, y+1, 1, 5, color);    // Left vertical
+        draw_rect(list, x+1, y+6, 4, 1, color);  // Bottom horizontal
+        draw_rect(list, x+4, y+1, 1, 1, color);  // Small top-right mark
+        draw_rect(list, x+4, y+5, 1, 1, color);  // Small bottom-right mark
+        break;
+
+    case 'o':
+        // 'o' should be a complete oval/rectangle without openings
+        draw_rect(list, x+1, y, 3, 1, color);    // Top horizontal
+        draw_rect(list, x, y+1, 1, 5, color);    // Left vertical
+        draw_rect(list, x+1, y+6, 3, 1, color);  // Bottom horizontal
+        draw_rect(list, x+4, y+1, 1, 5, color);  // Right vertical
+        break;
+
+    case 'r':
+        // 'r' should have a stem and a hook at the top right
+        draw_rect(list, x, y, 1, 7, color);      // Left vertical (full height)
+        draw_rect(list, x+1, y, 3, 1, color);    // Top horizontal
+        draw_rect(list, x+4, y+1, 1, 2, color);  // Right vertical (small hook)
+        break;
+
+        case 'e':
+        // 'e' has issues with vertical positions for right segments
+        draw_rect(list, x+1, y, 3, 1, color);    // Top horizontal
+        draw_rect(list, x, y+1, 1, 5, color);    // Left vertical
+        draw_rect(list, x+1, y+3, 3, 1, color);  // Middle horizontal
+        draw_rect(list, x+1, y+6, 3, 1, color);  // Bottom horizontal
+        draw_rect(list, x+4, y+1, 1, 2, color);  // Right vertical (top portion)
+        draw_rect(list, x+4, y+4, 1, 2, color);  // Right vertical (bottom portion)
+        break;
+
+
+
+        case ':':
+            draw_rect(list, x+2, y+2, 1, 1, color);
+            draw_rect(list, x+2, y+4, 1, 1, color);
+            break;
+        case ' ':
+            // Space character - do nothing
+            break;
+    }
+}
+
+// Function to draw a string using the pixel buffer
+void draw_text(struct DisplayList *list, int x, int y, const char *text, Uint8 color) {
+    int char_width = 6; // Width of each character including spacing
+    int pos_x = x;
+    
+    for (int i = 0; text[i] != '\0'; i++) {
+        draw_char(list, pos_x, y, text[i], color);
+        pos_x += char_width;
+    }
+}
+
+// Function to draw a small ship cursor for lives display
+void draw_ship_cursor(struct DisplayList *list, int x, int y) {
+    // Draw a small ship shape (triangle)
+    // Main body
+    draw_rect(list, x, y, 3, 3, PAL_HUD);
+    // Left wing
+    draw_rect(list, x-1, y+1, 2, 1, PAL_HUD);
+    // Right wing
+    draw_rect(list, x+2, y+1, 2, 1, PAL_HUD);
+}
+
+// Function to draw a frame of play: asteroids, bullets, the ship, lives and score.
+// The screen has to be cleared first.
+void draw_game(struct DisplayList *list, const GameState<GameSim> *state,
+               const Sint16 shapes[MAX_ASTEROIDS][ASTEROID_VERTICES][2], const char *score_text) {
+    const PlayerT<GameSim> *player = &state->player;
+
+    // Draw all asteroids
+    for (int i = 0; i < state->asteroid_count; i++) {
+        draw_asteroid(list, &state->asteroids[i], shapes[i]);
+    }
+    
+    // Draw bullets
+    draw_bullets(list, state);
+    
+    // Draw the player, its palette entry flashes while it is invulnerable
+    draw_player(list, player->x, player->y, player->rotation);
+    
+    // Draw lives as ship cursors in top-right corner
+    const int life_rect_size = 8;
+    const int life_rect_spacing = 2;
+    const int life_rect_y = 5;
+    
+    for (int i = 0; i < player->lives; i++) {
+        int life_rect_x = WIDTH - (i + 1) * (life_rect_size + life_rect_spacing);
+        draw_ship_cursor(list, life_rect_x, life_rect_y);
+    }
+    
+    // Draw score text in top-left corner using our custom text drawing function
+    if (score_text) {
+        draw_text(list, 10, 10, score_text, PAL_HUD);
+    }
+}
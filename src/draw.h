@@ -0,0 +1,28 @@
+#pragma once
+
+#include "game_config.h"
+#include <SDL3/SDL.h>
+#include "sim.h"
+#include "palette.h"
+#include "displaylist.h"
+
+// The game's drawing. Everything is recorded into a display list (see
+// displaylist.h), so the game and the benchmarks draw exactly the same frames.
+
+void draw_rect(struct DisplayList *list, int x, int y, int w, int h, Uint8 color);
+void draw_line(struct DisplayList *list, int x0, int y0, int x1, int y1, Uint8 color);
+
+// Make up a lumpy outline for each asteroid slot, as offsets from the center
+// in 1/256ths of the asteroid's radius
+void init_asteroid_shapes(Sint16 shapes[MAX_ASTEROIDS][ASTEROID_VERTICES][2]);
+
+void draw_asteroid(struct DisplayList *list, const AsteroidT<GameSim> *myAsteroid, const Sint16 shape[ASTEROID_VERTICES][2]);
+void draw_bullets(struct DisplayList *list, const GameState<GameSim> *state);
+void draw_player(struct DisplayList *list, GameSim::Position x, GameSim::Position y, GameSim::Scalar rotation);
+void draw_char(struct DisplayList *list, int x, int y, char c, Uint8 color);
+void draw_text(struct DisplayList *list, int x, int y, const char *text, Uint8 color);
+void draw_ship_cursor(struct DisplayList *list, int x, int y);
+
+// A frame of play, on top of a cleared screen. score_text may be NULL.
+void draw_game(struct DisplayList *list, const GameState<GameSim> *state,
+               const Sint16 shapes[MAX_ASTEROIDS][ASTEROID_VERTICES][2], const char *score_text);
@@ -0,0 +1,126 @@
+#include "eventlog.h"
+
+// How often the background thread empties the ring
+#define EVENT_LOG_DRAIN_INTERVAL_MS 50
+
+struct EventLog event_log;
+
+static SDL_Thread *drain_thread = NULL;
+static std::atomic<bool> drain_running(false);
+
+static const char *level_names[] = { "debug", "info", "warn" };
+
+// printf style formats, each may use the record's a and b in that order
+static const char *event_formats[EV_COUNT] = {
+    "Rotate left",
+    "Rotate right",
+    "Thrust",
+    "Shot fired, %d bullets",
+    "Score: %d",
+    "Collision! Lives remaining: %d",
+    "Game over, final score %d",
+    "Frame arena peak %d bytes, %d allocations failed",
+    "[perf] Per frame averages over %d frames",
+    "[perf] %-8s cycles %d",
+    "[perf] %-8s instructions %d",
+    "[perf] %-8s L1d misses %d",
+    "[perf] %-8s LLC misses %d",
+    "[perf] %-8s branch misses %d",
+    "[perf] %-8s instructions per 100 cycles %d",
+};
+
+// Names of the counters telemetry_report prints. Only events pushed with
+// TELEMETRY are counted, the rest are NULL.
+static const char *telemetry_names[EV_COUNT] = {
+    NULL,         // EV_ROTATE_LEFT
+    NULL,         // EV_ROTATE_RIGHT
+    NULL,         // EV_THRUST
+    "shots",      // EV_SHOT
+    "hits",       // EV_HIT
+    "lives_lost", // EV_LIFE_LOST
+    "games_over", // EV_GAME_OVER
+    NULL,         // EV_ARENA_PEAK
+    NULL,         // EV_PERF_REPORT
+    NULL,         // EV_PERF_CYCLES
+    NULL,         // EV_PERF_INSTRUCTIONS
+    NULL,         // EV_PERF_L1D_MISSES
+    NULL,         // EV_PERF_LLC_MISSES
+    NULL,         // EV_PERF_BRANCH_MISSES
+    NULL,         // EV_PERF_IPC
+};
+
+// Events whose a is an index into a table of names, see eventlog_set_labels
+static const char *const *event_labels[EV_COUNT];
+static int event_label_counts[EV_COUNT];
+
+void eventlog_set_labels(LogEvent event, const char *const *labels, int count) {
+    event_labels[event] = labels;
+    event_label_counts[event] = count;
+}
+
+int eventlog_drain() {
+    Uint32 tail = event_log.tail.load(std::memory_order_relaxed);
+    Uint32 head = event_log.head.load(std::memory_order_acquire);
+    int printed = 0;
+
+    for (; tail != head; tail++) {
+        const struct LogRecord *record = &event_log.records[tail & (EVENT_LOG_CAPACITY - 1)];
+        char message[96];
+        if (record->event < EV_COUNT && event_labels[record->event]) {
+            const char *label = record->a >= 0 && record->a < event_label_counts[record->event] ? event_labels[record->event][record->a] : "?";
+            SDL_snprintf(message, sizeof(message), event_formats[record->event], label, record->b);
+        } else {
+            const char *format = record->event < EV_COUNT ? event_formats[record->event] : "Unknown event %d %d";
+            SDL_snprintf(message, sizeof(message), format, record->a, record->b);
+        }
+
+        const char *level = record->level < LOG_LEVEL_NONE ? level_names[record->level] : "?";
+        SDL_Log("[%u] %s: %s", record->frame, level, message);
+        printed++;
+    }
+    event_log.tail.store(tail, std::memory_order_release);
+    return printed;
+}
+
+static int drain_thread_main(void *data) {
+    (void)data;
+    while (drain_running.load(std::memory_order_acquire)) {
+        eventlog_drain();
+        SDL_Delay(EVENT_LOG_DRAIN_INTERVAL_MS);
+    }
+    return 0;
+}
+
+bool eventlog_start_thread() {
+    if (drain_thread) {
+        return true;
+    }
+    drain_running.store(true, std::memory_order_release);
+    drain_thread = SDL_CreateThread(drain_thread_main, "eventlog", NULL);
+    if (!drain_thread) {
+        drain_running.store(false, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void eventlog_stop() {
+    if (drain_thread) {
+        drain_running.store(false, std::memory_order_release);
+        SDL_WaitThread(drain_thread, NULL);
+        drain_thread = NULL;
+    }
+    eventlog_drain();
+    if (event_log.dropped) {
+        SDL_Log("Event log dropped %u records", event_log.dropped);
+    }
+}
+
+void telemetry_report() {
+    SDL_Log("Telemetry after %u frames:", event_log.frame);
+    for (int i = 0; i < EV_COUNT; i++) {
+        if (telemetry_names[i]) {
+            SDL_Log("  %-12s %u", telemetry_names[i], event_log.counters[i]);
+        }
+    }
+}
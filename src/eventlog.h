@@ -0,0 +1,133 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <atomic>
+
+// Structured event log.
+// The game pushes fixed-size binary records into a lock-free ring, and
+// formatting/printing happens later on a background thread or whenever
+// eventlog_drain() is called, so nothing in the frame waits on stdio or a UART.
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_NONE 3
+
+// Calls below this level are compiled out entirely
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Must be a power of two
+#define EVENT_LOG_CAPACITY 1024
+
+enum LogEvent : Uint16 {
+    EV_ROTATE_LEFT,
+    EV_ROTATE_RIGHT,
+    EV_THRUST,
+    EV_SHOT,               // a = bullets in flight
+    EV_HIT,                // a = new score
+    EV_LIFE_LOST,          // a = lives remaining
+    EV_GAME_OVER,          // a = final score
+    EV_ARENA_PEAK,         // a = peak frame arena bytes, b = allocations that failed
+    EV_PERF_REPORT,        // a = frames the averages below cover
+    EV_PERF_CYCLES,        // a = phase label, b = per frame average
+    EV_PERF_INSTRUCTIONS,  // a = phase label, b = per frame average
+    EV_PERF_L1D_MISSES,    // a = phase label, b = per frame average
+    EV_PERF_LLC_MISSES,    // a = phase label, b = per frame average
+    EV_PERF_BRANCH_MISSES, // a = phase label, b = per frame average
+    EV_PERF_IPC,           // a = phase label, b = instructions per 100 cycles
+    EV_COUNT
+};
+
+struct LogRecord {
+    Uint32 frame;
+    Uint16 event;
+    Uint8 level;
+    Uint8 reserved;
+    Sint32 a;
+    Sint32 b;
+};
+
+// Single producer (the game loop), single consumer (the drain)
+struct EventLog {
+    alignas(64) std::atomic<Uint32> head; // next slot the producer writes
+    alignas(64) std::atomic<Uint32> tail; // next slot the consumer reads
+    alignas(64) struct LogRecord records[EVENT_LOG_CAPACITY];
+    Uint32 frame;
+    Uint32 dropped; // records lost because the ring was full
+    Uint32 counters[EV_COUNT];
+    bool muted; // Drop everything, e.g. while benchmarks run the simulation
+};
+
+extern struct EventLog event_log;
+
+// Push a record, never blocks. Drops the record if the ring is full.
+static inline void eventlog_push(Uint8 level, LogEvent event, Sint32 a, Sint32 b) {
+    if (event_log.muted) {
+        return;
+    }
+    Uint32 head = event_log.head.load(std::memory_order_relaxed);
+    if (head - event_log.tail.load(std::memory_order_acquire) >= EVENT_LOG_CAPACITY) {
+        event_log.dropped++;
+        return;
+    }
+    struct LogRecord *record = &event_log.records[head & (EVENT_LOG_CAPACITY - 1)];
+    record->frame = event_log.frame;
+    record->event = event;
+    record->level = level;
+    record->a = a;
+    record->b = b;
+    event_log.head.store(head + 1, std::memory_order_release);
+}
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(event, a, b) eventlog_push(LOG_LEVEL_DEBUG, event, a, b)
+#else
+#define LOG_DEBUG(event, a, b) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(event, a, b) eventlog_push(LOG_LEVEL_INFO, event, a, b)
+#else
+#define LOG_INFO(event, a, b) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(event, a, b) eventlog_push(LOG_LEVEL_WARN, event, a, b)
+#else
+#define LOG_WARN(event, a, b) ((void)0)
+#endif
+
+// Telemetry events are always counted, and logged at info level when that is compiled in
+#define TELEMETRY(event, a, b) do { if (!event_log.muted) { event_log.counters[event]++; LOG_INFO(event, a, b); } } while (0)
+
+static inline void eventlog_set_muted(bool muted) {
+    event_log.muted = muted;
+}
+
+// Advance the frame number stamped on new records
+static inline void eventlog_next_frame() {
+    event_log.frame++;
+}
+
+static inline Uint32 telemetry_count(LogEvent event) {
+    return event_log.counters[event];
+}
+
+// Give `event` a table of names. Its records then print labels[a] (a string
+// the producer can't put in a record) in place of a. Set before pushing any.
+void eventlog_set_labels(LogEvent event, const char *const *labels, int count);
+
+// Format and print everything in the ring. Returns the number of records printed.
+int eventlog_drain();
+
+// Start a background thread that drains the ring periodically.
+// Returns false if threads are unavailable, in which case call eventlog_drain() yourself.
+bool eventlog_start_thread();
+
+// Stop the background thread (if any) and print whatever is left
+void eventlog_stop();
+
+// Print the telemetry counters, for the events that are pushed with TELEMETRY
+void telemetry_report();
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <stdint.h>
+#include <compare>
+
+// Fixed-point number with `Frac` fractional bits stored in `Storage`.
+// Conversions from float are constexpr so constants like FRICTION cost nothing
+// at runtime, which matters on targets without an FPU.
+template <typename Storage, int Frac>
+struct Fixed {
+    Storage raw;
+
+    static constexpr int64_t one = (int64_t)1 << Frac;
+
+    constexpr Fixed() = default;
+    constexpr explicit Fixed(int v) : raw((Storage)((int64_t)v * one)) {}
+    constexpr explicit Fixed(float v) : raw((Storage)(v * one + (v < 0 ? -0.5f : 0.5f))) {}
+    constexpr explicit Fixed(double v) : raw((Storage)(v * one + (v < 0 ? -0.5 : 0.5))) {}
+
+    // Conversion between formats shifts the raw value into place. Dropping bits
+    // rounds to nearest, since a plain shift floors and would pull every
+    // position update (velocity added to position each tick) the same way.
+    template <typename S2, int F2>
+    constexpr explicit Fixed(Fixed<S2, F2> o) {
+        if constexpr (F2 > Frac) {
+            raw = (Storage)(((int64_t)o.raw + ((int64_t)1 << (F2 - Frac - 1))) >> (F2 - Frac));
+        } else {
+            raw = (Storage)((int64_t)o.raw << (Frac - F2));
+        }
+    }
+
+    static constexpr Fixed from_raw(int64_t r) {
+        Fixed f;
+        f.raw = (Storage)r;
+        return f;
+    }
+
+    // Truncates toward zero, like a float to int cast
+    constexpr explicit operator int() const { return (int)(raw / one); }
+    constexpr explicit operator float() const { return (float)raw / one; }
+
+    constexpr Fixed operator-() const { return from_raw(-(int64_t)raw); }
+    constexpr Fixed operator+(Fixed o) const { return from_raw((int64_t)raw + o.raw); }
+    constexpr Fixed operator-(Fixed o) const { return from_raw((int64_t)raw - o.raw); }
+
+    // The product keeps this operand's format. It is rounded to nearest: truncating
+    // would bias friction, which multiplies the player's velocity every tick, and
+    // make the fixed-point ship drift away from the float one within seconds.
+    template <typename S2, int F2>
+    constexpr Fixed operator*(Fixed<S2, F2> o) const {
+        int64_t product = (int64_t)raw * o.raw;
+        int64_t half = (int64_t)1 << (F2 - 1);
+        return from_raw((product + (product < 0 ? -half : half)) / ((int64_t)1 << F2));
+    }
+    constexpr Fixed operator/(Fixed o) const { return from_raw(((int64_t)raw * one) / o.raw); }
+
+    constexpr Fixed &operator+=(Fixed o) { return *this = *this + o; }
+    constexpr Fixed &operator-=(Fixed o) { return *this = *this - o; }
+    template <typename S2, int F2>
+    constexpr Fixed &operator*=(Fixed<S2, F2> o) { return *this = *this * o; }
+
+    constexpr bool operator==(const Fixed &o) const = default;
+    constexpr auto operator<=>(const Fixed &o) const = default;
+};
+
+typedef Fixed<int32_t, 16> Q16_16;
+typedef Fixed<int32_t, 24> Q8_24;
+typedef Fixed<int16_t, 14> Q2_14;
+
+namespace fixed_detail {
+    constexpr double pi = 3.14159265358979323846;
+
+    // Taylor series sine, only used to build the lookup table at compile time
+    constexpr double taylor_sin(double x) {
+        while (x > pi) x -= 2 * pi;
+        while (x < -pi) x += 2 * pi;
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 12; n++) {
+            term *= -x * x / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr int sin_table_bits = 10;
+    constexpr int sin_table_size = 1 << sin_table_bits;
+
+    struct SinTable {
+        int32_t values[sin_table_size + 1]; // Q16.16, one extra entry so interpolation never wraps
+    };
+
+    constexpr SinTable make_sin_table() {
+        SinTable t{};
+        for (int i = 0; i <= sin_table_size; i++) {
+            double v = taylor_sin(2 * pi * i / sin_table_size) * 65536.0;
+            t.values[i] = (int32_t)(v + (v < 0 ? -0.5 : 0.5));
+        }
+        return t;
+    }
+
+    inline constexpr SinTable sin_table = make_sin_table();
+}
+
+// Sine of an angle in degrees, from the table with linear interpolation
+template <typename Storage, int Frac>
+constexpr Fixed<Storage, Frac> fixed_sin_deg(Fixed<Storage, Frac> degrees) {
+    using namespace fixed_detail;
+    // Position in the table with 16 extra bits for interpolation
+    const int64_t full_turn = (int64_t)360 << Frac;
+    int64_t turn = ((int64_t)degrees.raw % full_turn + full_turn) % full_turn;
+    int64_t pos = (turn << (sin_table_bits + 16)) / full_turn;
+    int index = (int)(pos >> 16);
+    int64_t frac = pos & 0xFFFF;
+    int64_t a = sin_table.values[index];
+    int64_t b = sin_table.values[index + 1];
+    int64_t value = a + (((b - a) * frac) >> 16); // Q16.16
+    return Fixed<Storage, Frac>(Q16_16::from_raw(value));
+}
+
+template <typename Storage, int Frac>
+constexpr Fixed<Storage, Frac> fixed_cos_deg(Fixed<Storage, Frac> degrees) {
+    return fixed_sin_deg(degrees + Fixed<Storage, Frac>(90));
+}
@@ -0,0 +1,183 @@
+#include "framebuffer.h"
+
+static const char *mode_names[UPLOAD_MODE_COUNT] = { "lock", "rects", "ring" };
+
+UploadMode upload_mode_from_name(const char *name) {
+    if (name) {
+        for (int i = 0; i < UPLOAD_MODE_COUNT; i++) {
+            if (SDL_strcasecmp(name, mode_names[i]) == 0) {
+                return (UploadMode)i;
+            }
+        }
+    }
+    return UPLOAD_AUTO;
+}
+
+const char *upload_mode_name(UploadMode mode) {
+    if (mode < 0 || mode >= UPLOAD_MODE_COUNT) {
+        return "auto";
+    }
+    return mode_names[mode];
+}
+
+bool framebuffer_init(struct Framebuffer *fb, SDL_Renderer *renderer, SDL_PixelFormat format, int width, int height, UploadMode mode) {
+    SDL_memset(fb, 0, sizeof(*fb));
+    fb->width = width;
+    fb->height = height;
+    fb->pitch = width * 4;
+    fb->renderer = renderer;
+    fb->format = format;
+
+    // 64 byte alignment keeps every row start friendly to vector loads and stores
+    fb->pixels = (char *)SDL_aligned_alloc(64, (size_t)fb->pitch * height);
+    fb->shadow = (char *)SDL_aligned_alloc(64, (size_t)fb->pitch * height);
+    if (!fb->pixels || !fb->shadow) {
+        framebuffer_destroy(fb);
+        return false;
+    }
+    SDL_memset(fb->pixels, 0, (size_t)fb->pitch * height);
+
+    for (int i = 0; i < FB_STREAMING_TEXTURES; i++) {
+        fb->textures[i] = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, width, height);
+        if (!fb->textures[i]) {
+            framebuffer_destroy(fb);
+            return false;
+        }
+        SDL_SetTextureScaleMode(fb->textures[i], SDL_SCALEMODE_NEAREST);
+    }
+
+    fb->calibrating = (mode == UPLOAD_AUTO);
+    fb->mode = fb->calibrating ? (UploadMode)0 : mode;
+    return true;
+}
+
+void framebuffer_destroy(struct Framebuffer *fb) {
+    for (int i = 0; i < FB_STREAMING_TEXTURES; i++) {
+        if (fb->textures[i]) {
+            SDL_DestroyTexture(fb->textures[i]);
+            fb->textures[i] = NULL;
+        }
+    }
+    SDL_aligned_free(fb->pixels);
+    SDL_aligned_free(fb->shadow);
+    fb->pixels = NULL;
+    fb->shadow = NULL;
+}
+
+// Lock the texture and copy row by row, since the texture pitch
+// does not have to match ours
+static bool upload_locked(struct Framebuffer *fb, SDL_Texture *texture) {
+    char *dst;
+    int dst_pitch;
+    if (!SDL_LockTexture(texture, NULL, (void **)&dst, &dst_pitch)) {
+        return false;
+    }
+    if (dst_pitch == fb->pitch) {
+        SDL_memcpy(dst, fb->pixels, (size_t)fb->pitch * fb->height);
+    } else {
+        for (int y = 0; y < fb->height; y++) {
+            SDL_memcpy(dst + y * dst_pitch, fb->pixels + y * fb->pitch, fb->pitch);
+        }
+    }
+    SDL_UnlockTexture(texture);
+    return true;
+}
+
+// Only send the bands of rows that differ from the previous upload
+static bool upload_rects(struct Framebuffer *fb, SDL_Texture *texture) {
+    if (!fb->shadow_valid) {
+        SDL_memcpy(fb->shadow, fb->pixels, (size_t)fb->pitch * fb->height);
+        fb->shadow_valid = true;
+        return SDL_UpdateTexture(texture, NULL, fb->pixels, fb->pitch);
+    }
+
+    int y = 0;
+    while (y < fb->height) {
+        // Skip unchanged rows
+        while (y < fb->height && SDL_memcmp(fb->pixels + y * fb->pitch, fb->shadow + y * fb->pitch, fb->pitch) == 0) {
+            y++;
+        }
+        if (y == fb->height) {
+            break;
+        }
+
+        // Extend the band over consecutive changed rows
+        int start = y;
+        while (y < fb->height && SDL_memcmp(fb->pixels + y * fb->pitch, fb->shadow + y * fb->pitch, fb->pitch) != 0) {
+            y++;
+        }
+
+        SDL_Rect band = { 0, start, fb->width, y - start };
+        char *src = fb->pixels + start * fb->pitch;
+        SDL_memcpy(fb->shadow + start * fb->pitch, src, (size_t)fb->pitch * band.h);
+        if (!SDL_UpdateTexture(texture, &band, src, fb->pitch)) {
+            fb->shadow_valid = false;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Pick the fastest mode once every mode has been timed
+static void finish_calibration(struct Framebuffer *fb) {
+    int best = 0;
+    Uint64 best_avg = 0;
+    for (int i = 0; i < UPLOAD_MODE_COUNT; i++) {
+        Uint64 avg = fb->stats[i].frames ? fb->stats[i].total_ns / fb->stats[i].frames : 0;
+        SDL_Log("Upload mode %-5s: avg %llu us, max %llu us", mode_names[i],
+                (unsigned long long)(avg / 1000), (unsigned long long)(fb->stats[i].max_ns / 1000));
+        if (i == 0 || avg < best_avg) {
+            best = i;
+            best_avg = avg;
+        }
+    }
+    fb->calibrating = false;
+    fb->mode = (UploadMode)best;
+    fb->shadow_valid = false;
+    SDL_Log("Using upload mode \"%s\" for renderer %s", mode_names[best], SDL_GetRendererName(fb->renderer));
+}
+
+SDL_Texture *framebuffer_upload(struct Framebuffer *fb) {
+    Uint64 start = SDL_GetTicksNS();
+
+    SDL_Texture *texture = fb->textures[0];
+    bool ok;
+    switch (fb->mode) {
+        case UPLOAD_UPDATE_RECTS:
+            ok = upload_rects(fb, texture);
+            break;
+        case UPLOAD_STREAMING_RING:
+            fb->current_texture = (fb->current_texture + 1) % FB_STREAMING_TEXTURES;
+            texture = fb->textures[fb->current_texture];
+            ok = upload_locked(fb, texture);
+            break;
+        case UPLOAD_LOCK_MEMCPY:
+        default:
+            ok = upload_locked(fb, texture);
+            break;
+    }
+    if (!ok) {
+        SDL_LogError(SDL_LOG_CATEGORY_CUSTOM, "Texture upload (%s) failed: %s", mode_names[fb->mode], SDL_GetError());
+    }
+
+    Uint64 elapsed = SDL_GetTicksNS() - start;
+    struct UploadStats *stats = &fb->stats[fb->mode];
+    stats->total_ns += elapsed;
+    stats->frames++;
+    if (elapsed > stats->max_ns) {
+        stats->max_ns = elapsed;
+    }
+
+    if (fb->calibrating && ++fb->calibration_frames >= FB_CALIBRATION_FRAMES) {
+        fb->calibration_frames = 0;
+        if (fb->mode + 1 < UPLOAD_MODE_COUNT) {
+            // Other modes wrote to the texture, so the shadow copy no longer matches it
+            fb->mode = (UploadMode)(fb->mode + 1);
+            fb->shadow_valid = false;
+        } else {
+            finish_calibration(fb);
+        }
+    }
+
+    return texture;
+}
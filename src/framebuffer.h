@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Number of streaming textures used by UPLOAD_STREAMING_RING
+#define FB_STREAMING_TEXTURES 3
+// Number of frames each upload mode is timed for while calibrating
+#define FB_CALIBRATION_FRAMES 120
+
+// Ways of getting the CPU framebuffer into a GPU texture.
+// Which one is fastest depends on the renderer backend, so by default
+// we time each of them for a few frames and keep the winner.
+enum UploadMode {
+    UPLOAD_LOCK_MEMCPY,    // SDL_LockTexture and copy each row honoring the texture pitch
+    UPLOAD_UPDATE_RECTS,   // SDL_UpdateTexture on the bands of rows that changed since the last upload
+    UPLOAD_STREAMING_RING, // Lock/copy into a rotating set of textures so we never wait on one still in use
+    UPLOAD_MODE_COUNT,
+    UPLOAD_AUTO = UPLOAD_MODE_COUNT
+};
+
+// Upload timing for one mode
+struct UploadStats {
+    Uint64 total_ns;
+    Uint64 max_ns;
+    int frames;
+};
+
+// Persistent CPU-side framebuffer.
+// The game draws into `pixels` (rows are `pitch` bytes apart) and the
+// buffer is pushed to a texture once per frame with framebuffer_upload().
+struct Framebuffer {
+    char *pixels;
+    int width;
+    int height;
+    int pitch;
+
+    // Copy of what was last uploaded, used to find changed rows
+    char *shadow;
+    bool shadow_valid;
+
+    SDL_Renderer *renderer;
+    SDL_PixelFormat format;
+    SDL_Texture *textures[FB_STREAMING_TEXTURES];
+    int current_texture;
+
+    UploadMode mode;
+    bool calibrating;
+    int calibration_frames;
+    struct UploadStats stats[UPLOAD_MODE_COUNT];
+};
+
+// Allocate the CPU buffer and the textures. Returns false on failure (see SDL_GetError()).
+bool framebuffer_init(struct Framebuffer *fb, SDL_Renderer *renderer, SDL_PixelFormat format, int width, int height, UploadMode mode);
+
+// Upload the CPU buffer using the current mode and return the texture to render
+SDL_Texture *framebuffer_upload(struct Framebuffer *fb);
+
+void framebuffer_destroy(struct Framebuffer *fb);
+
+// Parse a mode name ("lock", "rects", "ring" or "auto"). Unknown or NULL names give UPLOAD_AUTO.
+UploadMode upload_mode_from_name(const char *name);
+const char *upload_mode_name(UploadMode mode);
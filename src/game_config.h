@@ -0,0 +1,22 @@
+#pragma once
+
+#define WIDTH 272
+#define HEIGHT 144
+#define PIXEL_SIZE 5
+#define MAX_ASTEROIDS 4
+#define ASTEROID_VERTICES 9 // Corners of each asteroid's outline
+#define PLAYER_SPEED 0.25f
+#define ROTATION_SPEED 3.0f // Degrees per tick while rotate is held
+#define THRUST_ACCELERATION 0.005f // Added to the speed each tick while thrust is held
+#define SHOT_COOLDOWN_TICKS 10 // Ticks between shots while shoot is held
+#define FRICTION 0.995f
+#define M_PI 3.14159265358979323846
+#define MAX_BULLETS 1000
+#define MAX_HITS_PER_TICK 8 // Hit positions kept per tick for explosion effects
+#define GAME_OVER_DURATION 1000
+#define FB_PITCH (WIDTH * 4) // Bytes per row of the CPU framebuffer
+#define INDEX_PITCH WIDTH // Bytes per row of the palette indexed game framebuffer
+#define FRAME_ARENA_SIZE (64 * 1024) // Bytes of per frame scratch memory (display list etc.)
+#define CONTROLLER_MESSAGE_LENGTH 8 // Bytes per message from the device controller, see input_decode_controller()
+#define CONTROLLER_STICK_CENTER 500 // Stick value the controller sends at rest
+#define CONTROLLER_STICK_DEADZONE 20 // Stick travel from the center that counts as pushed
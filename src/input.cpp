@@ -0,0 +1,89 @@
+#include "input.h"
+
+// Use the first gamepad that is connected, if any
+static void open_first_gamepad(struct InputState *input) {
+    int count = 0;
+    SDL_JoystickID *ids = SDL_GetGamepads(&count);
+    if (ids && count > 0) {
+        input->gamepad = SDL_OpenGamepad(ids[0]);
+    }
+    SDL_free(ids);
+}
+
+void input_init(struct InputState *input) {
+    input->gamepad = NULL;
+    input->pressed = EVENTS{};
+    input->sampled_ns = 0;
+    open_first_gamepad(input);
+}
+
+void input_shutdown(struct InputState *input) {
+    if (input->gamepad) {
+        SDL_CloseGamepad(input->gamepad);
+        input->gamepad = NULL;
+    }
+}
+
+bool input_handle_event(struct InputState *input, const SDL_Event *event) {
+    switch (event->type) {
+        case SDL_EVENT_KEY_DOWN:
+            switch (event->key.scancode) {
+                case SDL_SCANCODE_LEFT: input->pressed.left_flag = true; return true;
+                case SDL_SCANCODE_RIGHT: input->pressed.right_flag = true; return true;
+                case SDL_SCANCODE_SPACE: input->pressed.thrust_flag = true; return true;
+                case SDL_SCANCODE_UP: input->pressed.shoot_flag = true; return true;
+                default: return false;
+            }
+        case SDL_EVENT_GAMEPAD_ADDED:
+            if (!input->gamepad) {
+                input->gamepad = SDL_OpenGamepad(event->gdevice.which);
+            }
+            return true;
+        case SDL_EVENT_GAMEPAD_REMOVED:
+            if (input->gamepad && SDL_GetGamepadID(input->gamepad) == event->gdevice.which) {
+                SDL_CloseGamepad(input->gamepad);
+                input->gamepad = NULL;
+                open_first_gamepad(input);
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+void input_decode_controller(const char *message, EVENTS *events) {
+    int x = (message[0] - '0') * 100 + (message[1] - '0') * 10 + (message[2] - '0') - CONTROLLER_STICK_CENTER;
+    // The stick's y axis (message[3] to [5]) isn't used yet
+    events->right_flag = x > CONTROLLER_STICK_DEADZONE;
+    events->left_flag = x < -CONTROLLER_STICK_DEADZONE;
+    events->shoot_flag = message[6] == '1';
+    events->thrust_flag = message[7] == '1';
+}
+
+void input_sample(struct InputState *input, EVENTS *events) {
+    // Fetch whatever the OS has queued so the state below is current
+    SDL_PumpEvents();
+    input->sampled_ns = SDL_GetTicksNS();
+
+    const bool *keys = SDL_GetKeyboardState(NULL);
+    bool left = keys[SDL_SCANCODE_LEFT] || input->pressed.left_flag;
+    bool right = keys[SDL_SCANCODE_RIGHT] || input->pressed.right_flag;
+    bool thrust = keys[SDL_SCANCODE_SPACE] || input->pressed.thrust_flag;
+    bool shoot = keys[SDL_SCANCODE_UP] || input->pressed.shoot_flag;
+    input->pressed = EVENTS{};
+
+    SDL_Gamepad *pad = input->gamepad;
+    if (pad) {
+        Sint16 stick = SDL_GetGamepadAxis(pad, SDL_GAMEPAD_AXIS_LEFTX);
+        left = left || stick < -INPUT_AXIS_DEADZONE || SDL_GetGamepadButton(pad, SDL_GAMEPAD_BUTTON_DPAD_LEFT);
+        right = right || stick > INPUT_AXIS_DEADZONE || SDL_GetGamepadButton(pad, SDL_GAMEPAD_BUTTON_DPAD_RIGHT);
+        thrust = thrust || SDL_GetGamepadButton(pad, SDL_GAMEPAD_BUTTON_SOUTH);
+        shoot = shoot || SDL_GetGamepadButton(pad, SDL_GAMEPAD_BUTTON_EAST) ||
+                SDL_GetGamepadAxis(pad, SDL_GAMEPAD_AXIS_RIGHT_TRIGGER) > INPUT_AXIS_DEADZONE;
+    }
+
+    events->left_flag = events->left_flag || left;
+    events->right_flag = events->right_flag || right;
+    events->thrust_flag = events->thrust_flag || thrust;
+    events->shoot_flag = events->shoot_flag || shoot;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include "sim.h"
+
+// Desktop input, sampled as held state right before each tick.
+// Key presses are also latched as they arrive, so a tap that is released
+// before the next tick still counts for that tick.
+// Keyboard: Left/Right rotate, Space thrusts, Up shoots.
+// Gamepad: left stick or d-pad rotates, A (south) thrusts, B (east) or right trigger shoots.
+
+// Stick and trigger travel (out of 32767) that counts as pressed
+#define INPUT_AXIS_DEADZONE 8000
+
+struct InputState {
+    SDL_Gamepad *gamepad;
+    EVENTS pressed;    // Keys pressed since the last sample
+    Uint64 sampled_ns; // When input was last sampled
+};
+
+void input_init(struct InputState *input);
+void input_shutdown(struct InputState *input);
+
+// Handle key presses and gamepads being plugged in and out. Returns true if the event was one of those.
+bool input_handle_event(struct InputState *input, const SDL_Event *event);
+
+// Add what is held right now to `events` (which may already hold the device controller's input)
+void input_sample(struct InputState *input, EVENTS *events);
+
+// Decode a message from the device controller into `events`. A message is
+// CONTROLLER_MESSAGE_LENGTH characters: three digits of stick x, three of
+// stick y (both 000 to 999, CONTROLLER_STICK_CENTER at rest), then the shoot
+// and thrust buttons as '0' or '1'.
+void input_decode_controller(const char *message, EVENTS *events);
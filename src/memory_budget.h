@@ -0,0 +1,78 @@
+#pragma once
+
+#include "game_config.h"
+#include <SDL3/SDL.h>
+#include <stddef.h>
+#include "sim.h"
+#include "snapshot.h"
+#include "particles.h"
+#include "palette.h"
+#include "eventlog.h"
+#include "fixed.h"
+
+// Static memory budget.
+// Everything the game keeps for its whole run has a size fixed at compile
+// time, and nothing is allocated once the frame loop runs (per frame data
+// goes in the frame arena). This table adds it all up, and the build fails
+// when the total doesn't fit in SRAM_BUDGET bytes, which is set with the
+// ASTEROIDS_SRAM_BUDGET CMake option. The default only catches runaway growth
+// on desktop. A board with a few hundred KB also needs a smaller
+// SNAPSHOT_HISTORY, PARTICLE_CAPACITY is already smaller on the device.
+// The framebuffer shadow copy is counted because every upload mode can be
+// picked at runtime, so it is always allocated. The fixed-point sine table is
+// counted even though it is const, in case it is kept in SRAM for speed.
+// Desktop builds may upscale on the CPU, which is picked at startup, so they
+// count the framebuffer at PIXEL_SIZE times the size each way plus the
+// upscaler's source image and LED masks. The device never upscales.
+
+#ifndef SRAM_BUDGET
+#define SRAM_BUDGET (16 * 1024 * 1024)
+#endif
+
+#if PICO_ON_DEVICE
+#define MEMORY_BUDGET_FB_SCALE 1
+#else
+#define MEMORY_BUDGET_FB_SCALE PIXEL_SIZE
+#endif
+
+struct MemoryBudgetEntry {
+    const char *name;
+    size_t bytes;
+};
+
+static constexpr struct MemoryBudgetEntry memory_budget[] = {
+    { "game state", offsetof(GameState<GameSim>, bullets) },
+    { "bullets", sizeof(BulletT<GameSim>) * MAX_BULLETS },
+    { "rewind history", sizeof(SnapshotHistory<GameSim>) },
+    { "particles", sizeof(ParticlePool) },
+    { "palette", sizeof(Palette) },
+    { "asteroid shapes", sizeof(Sint16) * MAX_ASTEROIDS * ASTEROID_VERTICES * 2 },
+    { "event log", sizeof(EventLog) },
+    { "index framebuffer", INDEX_PITCH * HEIGHT },
+    { "framebuffer", FB_PITCH * HEIGHT * MEMORY_BUDGET_FB_SCALE * MEMORY_BUDGET_FB_SCALE },
+    { "framebuffer shadow", FB_PITCH * HEIGHT * MEMORY_BUDGET_FB_SCALE * MEMORY_BUDGET_FB_SCALE },
+#if !PICO_ON_DEVICE
+    { "upscale source", FB_PITCH * HEIGHT },
+    { "upscale masks", 2 * sizeof(Uint32) * WIDTH * PIXEL_SIZE * PIXEL_SIZE },
+#endif
+    { "sine table", sizeof(fixed_detail::sin_table) },
+    { "frame arena", FRAME_ARENA_SIZE },
+};
+
+static constexpr size_t memory_budget_total() {
+    size_t total = 0;
+    for (const struct MemoryBudgetEntry &entry : memory_budget) {
+        total += entry.bytes;
+    }
+    return total;
+}
+
+static_assert(memory_budget_total() <= SRAM_BUDGET, "Static memory doesn't fit in SRAM_BUDGET, see memory_budget.h");
+
+// Log the table
+static inline void memory_budget_report() {
+    SDL_Log("Static memory, %zu of %zu bytes:", memory_budget_total(), (size_t)SRAM_BUDGET);
+    for (const struct MemoryBudgetEntry &entry : memory_budget) {
+        SDL_Log("  %-18s %8zu", entry.name, entry.bytes);
+    }
+}
@@ -0,0 +1,72 @@
+#include "pacer.h"
+
+void pacer_init(struct PresentPacer *pacer, float refresh_hz, bool enabled) {
+    SDL_memset(pacer, 0, sizeof(*pacer));
+    if (refresh_hz <= 0) {
+        refresh_hz = 60;
+    }
+    pacer->enabled = enabled;
+    pacer->period_ns = (Uint64)(SDL_NS_PER_SECOND / refresh_hz);
+    pacer->margin_ns = PACER_MIN_MARGIN_NS;
+}
+
+// Slowest recent frame, so one heavy frame (an explosion) doesn't immediately miss
+static Uint64 recent_work(const struct PresentPacer *pacer) {
+    Uint64 slowest = 0;
+    for (int i = 0; i < PACER_HISTORY; i++) {
+        slowest = SDL_max(slowest, pacer->work_ns[i]);
+    }
+    return slowest;
+}
+
+void pacer_wait(struct PresentPacer *pacer) {
+    Uint64 now = SDL_GetTicksNS();
+    if (pacer->enabled && pacer->last_present_ns) {
+        // Work that doesn't fit in a period at all gets no delay
+        Uint64 budget = recent_work(pacer) + pacer->margin_ns;
+        if (budget < pacer->period_ns) {
+            Uint64 start = pacer->last_present_ns + pacer->period_ns - budget;
+            if (start > now) {
+                SDL_DelayPrecise(start - now);
+                pacer->waited_ns += start - now;
+                now = SDL_GetTicksNS();
+            }
+        }
+    }
+    pacer->frame_start_ns = now;
+}
+
+void pacer_work_done(struct PresentPacer *pacer) {
+    pacer->work_ns[pacer->work_index] = SDL_GetTicksNS() - pacer->frame_start_ns;
+    pacer->work_index = (pacer->work_index + 1) % PACER_HISTORY;
+}
+
+void pacer_presented(struct PresentPacer *pacer) {
+    Uint64 now = SDL_GetTicksNS();
+    if (pacer->last_present_ns) {
+        pacer->frames++;
+        // More than one and a half periods between presents means a vblank went by without a new frame
+        if ((now - pacer->last_present_ns) * 2 > pacer->period_ns * 3) {
+            pacer->missed++;
+            pacer->good_streak = 0;
+            pacer->margin_ns = SDL_min(pacer->margin_ns + PACER_MARGIN_STEP_UP_NS, pacer->period_ns / 2);
+        } else if (++pacer->good_streak >= PACER_GOOD_STREAK) {
+            pacer->good_streak = 0;
+            if (pacer->margin_ns >= PACER_MIN_MARGIN_NS + PACER_MARGIN_STEP_DOWN_NS) {
+                pacer->margin_ns -= PACER_MARGIN_STEP_DOWN_NS;
+            }
+        }
+    }
+    pacer->last_present_ns = now;
+}
+
+void pacer_report(const struct PresentPacer *pacer) {
+    if (!pacer->frames) {
+        return;
+    }
+    SDL_Log("Present pacing %s: %llu frames, %llu missed, %.2f ms average delay, %.2f ms margin, %.2f ms recent work",
+            pacer->enabled ? "on" : "off",
+            (unsigned long long)pacer->frames, (unsigned long long)pacer->missed,
+            (double)pacer->waited_ns / pacer->frames / SDL_NS_PER_MS,
+            (double)pacer->margin_ns / SDL_NS_PER_MS, (double)recent_work(pacer) / SDL_NS_PER_MS);
+}
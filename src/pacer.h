@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Present pacing.
+// With vsync, SDL_RenderPresent() blocks until the next vblank, so a frame
+// that starts right after the previous present samples input almost a whole
+// refresh period before it is shown. The pacer measures how long recent frames
+// took from input sampling to present, and sleeps at the start of the frame so
+// the work finishes just before the vblank instead. A missed vblank widens the
+// safety margin, and a long run of frames on time narrows it again.
+
+// Frames of work time remembered, the slowest of them sets the budget
+#define PACER_HISTORY 32
+
+// Safety margin bounds and steps, in nanoseconds
+#define PACER_MIN_MARGIN_NS 1000000
+#define PACER_MARGIN_STEP_UP_NS 500000
+#define PACER_MARGIN_STEP_DOWN_NS 100000
+// Frames on time in a row before the margin is narrowed
+#define PACER_GOOD_STREAK 120
+
+struct PresentPacer {
+    bool enabled;
+    Uint64 period_ns;       // One refresh
+    Uint64 margin_ns;       // Extra time left before the vblank
+    Uint64 frame_start_ns;  // When the current frame's work began
+    Uint64 last_present_ns; // When the previous present returned, 0 if none yet
+    Uint64 work_ns[PACER_HISTORY];
+    int work_index;
+    int good_streak;
+    // Totals for pacer_report()
+    Uint64 frames;
+    Uint64 missed;
+    Uint64 waited_ns;
+};
+
+// Pace presents to `refresh_hz`. Disabled pacers never wait but still count missed frames.
+void pacer_init(struct PresentPacer *pacer, float refresh_hz, bool enabled);
+
+// Sleep until the frame should start, call before sampling input
+void pacer_wait(struct PresentPacer *pacer);
+
+// The frame's work is done, call right before SDL_RenderPresent()
+void pacer_work_done(struct PresentPacer *pacer);
+
+// SDL_RenderPresent() has returned
+void pacer_presented(struct PresentPacer *pacer);
+
+// Log how pacing went
+void pacer_report(const struct PresentPacer *pacer);
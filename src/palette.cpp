@@ -0,0 +1,195 @@
+#include "palette.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PALETTE_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define PALETTE_SSE41_TARGET __attribute__((target("sse4.1")))
+#define PALETTE_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define PALETTE_SSE41_TARGET
+#define PALETTE_AVX2_TARGET
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define PALETTE_NEON 1
+#include <arm_neon.h>
+#endif
+
+static const char *kernel_names[PALETTE_KERNEL_COUNT] = { "scalar", "sse41", "avx2", "neon" };
+
+// Expand one row of `width` indices
+typedef void (*ExpandRowFn)(const struct Palette *pal, const Uint8 *src, Uint32 *dst, int width);
+
+static void expand_row_scalar(const struct Palette *pal, const Uint8 *src, Uint32 *dst, int width) {
+    for (int i = 0; i < width; i++) {
+        dst[i] = pal->colors[src[i] & (PALETTE_SIZE - 1)];
+    }
+}
+
+#ifdef PALETTE_X86
+// Look up 16 indices in each byte plane, then interleave the planes back into pixels.
+// pshufb needs SSSE3, SDL only reports SSE4.1 which implies it.
+PALETTE_SSE41_TARGET
+static void expand_row_sse41(const struct Palette *pal, const Uint8 *src, Uint32 *dst, int width) {
+    const __m128i mask = _mm_set1_epi8(PALETTE_SIZE - 1);
+    const __m128i r_plane = _mm_load_si128((const __m128i *)pal->planes[0]);
+    const __m128i g_plane = _mm_load_si128((const __m128i *)pal->planes[1]);
+    const __m128i b_plane = _mm_load_si128((const __m128i *)pal->planes[2]);
+    const __m128i x_plane = _mm_load_si128((const __m128i *)pal->planes[3]);
+    int i = 0;
+    for (; i + 16 <= width; i += 16) {
+        __m128i idx = _mm_and_si128(_mm_loadu_si128((const __m128i *)(src + i)), mask);
+        __m128i r = _mm_shuffle_epi8(r_plane, idx);
+        __m128i g = _mm_shuffle_epi8(g_plane, idx);
+        __m128i b = _mm_shuffle_epi8(b_plane, idx);
+        __m128i x = _mm_shuffle_epi8(x_plane, idx);
+        __m128i rg_lo = _mm_unpacklo_epi8(r, g);
+        __m128i rg_hi = _mm_unpackhi_epi8(r, g);
+        __m128i bx_lo = _mm_unpacklo_epi8(b, x);
+        __m128i bx_hi = _mm_unpackhi_epi8(b, x);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_unpacklo_epi16(rg_lo, bx_lo));
+        _mm_storeu_si128((__m128i *)(dst + i + 4), _mm_unpackhi_epi16(rg_lo, bx_lo));
+        _mm_storeu_si128((__m128i *)(dst + i + 8), _mm_unpacklo_epi16(rg_hi, bx_hi));
+        _mm_storeu_si128((__m128i *)(dst + i + 12), _mm_unpackhi_epi16(rg_hi, bx_hi));
+    }
+    expand_row_scalar(pal, src + i, dst + i, width - i);
+}
+
+// Same as SSE4.1 on 32 indices. The unpacks work within 128 bit lanes,
+// so the halves are put back in order with a final permute.
+PALETTE_AVX2_TARGET
+static void expand_row_avx2(const struct Palette *pal, const Uint8 *src, Uint32 *dst, int width) {
+    const __m256i mask = _mm256_set1_epi8(PALETTE_SIZE - 1);
+    const __m256i r_plane = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)pal->planes[0]));
+    const __m256i g_plane = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)pal->planes[1]));
+    const __m256i b_plane = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)pal->planes[2]));
+    const __m256i x_plane = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)pal->planes[3]));
+    int i = 0;
+    for (; i + 32 <= width; i += 32) {
+        __m256i idx = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(src + i)), mask);
+        __m256i r = _mm256_shuffle_epi8(r_plane, idx);
+        __m256i g = _mm256_shuffle_epi8(g_plane, idx);
+        __m256i b = _mm256_shuffle_epi8(b_plane, idx);
+        __m256i x = _mm256_shuffle_epi8(x_plane, idx);
+        __m256i rg_lo = _mm256_unpacklo_epi8(r, g);
+        __m256i rg_hi = _mm256_unpackhi_epi8(r, g);
+        __m256i bx_lo = _mm256_unpacklo_epi8(b, x);
+        __m256i bx_hi = _mm256_unpackhi_epi8(b, x);
+        // Pixels 0-3|16-19, 4-7|20-23, 8-11|24-27, 12-15|28-31
+        __m256i p0 = _mm256_unpacklo_epi16(rg_lo, bx_lo);
+        __m256i p1 = _mm256_unpackhi_epi16(rg_lo, bx_lo);
+        __m256i p2 = _mm256_unpacklo_epi16(rg_hi, bx_hi);
+        __m256i p3 = _mm256_unpackhi_epi16(rg_hi, bx_hi);
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_permute2x128_si256(p0, p1, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + i + 8), _mm256_permute2x128_si256(p2, p3, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + i + 16), _mm256_permute2x128_si256(p0, p1, 0x31));
+        _mm256_storeu_si256((__m256i *)(dst + i + 24), _mm256_permute2x128_si256(p2, p3, 0x31));
+    }
+    expand_row_scalar(pal, src + i, dst + i, width - i);
+}
+#endif
+
+#ifdef PALETTE_NEON
+// Table lookups per plane, and the interleaving store puts the pixels together
+static void expand_row_neon(const struct Palette *pal, const Uint8 *src, Uint32 *dst, int width) {
+    const uint8x16_t mask = vdupq_n_u8(PALETTE_SIZE - 1);
+    const uint8x16_t r_plane = vld1q_u8(pal->planes[0]);
+    const uint8x16_t g_plane = vld1q_u8(pal->planes[1]);
+    const uint8x16_t b_plane = vld1q_u8(pal->planes[2]);
+    const uint8x16_t x_plane = vld1q_u8(pal->planes[3]);
+    int i = 0;
+    for (; i + 16 <= width; i += 16) {
+        uint8x16_t idx = vandq_u8(vld1q_u8(src + i), mask);
+        uint8x16x4_t pixels;
+        pixels.val[0] = vqtbl1q_u8(r_plane, idx);
+        pixels.val[1] = vqtbl1q_u8(g_plane, idx);
+        pixels.val[2] = vqtbl1q_u8(b_plane, idx);
+        pixels.val[3] = vqtbl1q_u8(x_plane, idx);
+        vst4q_u8((Uint8 *)(dst + i), pixels);
+    }
+    expand_row_scalar(pal, src + i, dst + i, width - i);
+}
+#endif
+
+bool palette_kernel_supported(PaletteKernel kernel) {
+    switch (kernel) {
+        case PALETTE_SCALAR:
+            return true;
+#ifdef PALETTE_X86
+        case PALETTE_SSE41:
+            return SDL_HasSSE41();
+        case PALETTE_AVX2:
+            return SDL_HasAVX2();
+#endif
+#ifdef PALETTE_NEON
+        case PALETTE_NEON:
+            return SDL_HasNEON();
+#endif
+        default:
+            return false;
+    }
+}
+
+PaletteKernel palette_best_kernel() {
+    const PaletteKernel preference[] = { PALETTE_AVX2, PALETTE_NEON, PALETTE_SSE41 };
+    for (PaletteKernel kernel : preference) {
+        if (palette_kernel_supported(kernel)) {
+            return kernel;
+        }
+    }
+    return PALETTE_SCALAR;
+}
+
+const char *palette_kernel_name(PaletteKernel kernel) {
+    if (kernel < 0 || kernel >= PALETTE_KERNEL_COUNT) {
+        return "unknown";
+    }
+    return kernel_names[kernel];
+}
+
+void palette_set(struct Palette *pal, Uint8 index, Uint8 r, Uint8 g, Uint8 b) {
+    index &= PALETTE_SIZE - 1;
+    Uint8 bytes[4] = { r, g, b, 0 };
+    SDL_memcpy(&pal->colors[index], bytes, sizeof(bytes));
+    for (int c = 0; c < 4; c++) {
+        pal->planes[c][index] = bytes[c];
+    }
+}
+
+void palette_init(struct Palette *pal) {
+    SDL_memset(pal, 0, sizeof(*pal));
+    palette_set(pal, PAL_BLACK, 0, 0, 0);
+    palette_set(pal, PAL_ASTEROID, 86, 107, 114);
+    palette_set(pal, PAL_BULLET, 127, 127, 0);
+    palette_set(pal, PAL_SHIP, 127, 127, 127);
+    palette_set(pal, PAL_HUD, 127, 127, 127);
+    palette_set(pal, PAL_GAME_OVER, 127, 0, 0);
+    pal->kernel = palette_best_kernel();
+}
+
+void palette_expand(const struct Palette *pal, const Uint8 *src, int src_pitch, char *dst, int dst_pitch, int width, int height) {
+    ExpandRowFn expand = expand_row_scalar;
+    switch (pal->kernel) {
+#ifdef PALETTE_X86
+        case PALETTE_SSE41:
+            expand = expand_row_sse41;
+            break;
+        case PALETTE_AVX2:
+            expand = expand_row_avx2;
+            break;
+#endif
+#ifdef PALETTE_NEON
+        case PALETTE_NEON:
+            expand = expand_row_neon;
+            break;
+#endif
+        default:
+            break;
+    }
+
+    for (int y = 0; y < height; y++) {
+        expand(pal, src + y * src_pitch, (Uint32 *)(dst + y * dst_pitch), width);
+    }
+}
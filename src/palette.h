@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Indexed color.
+// The game draws 1 byte palette indices and the frame is expanded to 32 bit
+// pixels once, right before it is blended/scaled/uploaded. Only the low 4 bits
+// of an index are used, so a whole palette fits in one SIMD register per channel.
+#define PALETTE_SIZE 16
+
+// Colors the game draws with. Things that may change color on their own
+// get their own entry even when it starts out the same as another one.
+// The HUD colors come last: particles are not blended over PAL_HUD and above.
+enum PaletteIndex : Uint8 {
+    PAL_BLACK,
+    PAL_ASTEROID,
+    PAL_BULLET,
+    PAL_SHIP,
+    PAL_HUD,
+    PAL_GAME_OVER,
+    PAL_GAME_COLORS
+};
+
+// Implementations of the expansion kernel, picked at runtime from what the CPU supports
+enum PaletteKernel {
+    PALETTE_SCALAR,
+    PALETTE_SSE41,
+    PALETTE_AVX2,
+    PALETTE_NEON,
+    PALETTE_KERNEL_COUNT
+};
+
+struct Palette {
+    Uint32 colors[PALETTE_SIZE]; // In framebuffer byte order
+    // The same colors split into one table per byte, for the shuffle based kernels
+    alignas(16) Uint8 planes[4][PALETTE_SIZE];
+    PaletteKernel kernel;
+};
+
+// Set up the game's colors and the fastest kernel
+void palette_init(struct Palette *pal);
+
+// Change one color, everything drawn with it changes with the next expansion
+void palette_set(struct Palette *pal, Uint8 index, Uint8 r, Uint8 g, Uint8 b);
+
+// Convert width x height indices into 32 bit pixels
+void palette_expand(const struct Palette *pal, const Uint8 *src, int src_pitch, char *dst, int dst_pitch, int width, int height);
+
+bool palette_kernel_supported(PaletteKernel kernel);
+PaletteKernel palette_best_kernel();
+const char *palette_kernel_name(PaletteKernel kernel);
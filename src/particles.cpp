@@ -0,0 +1,155 @@
+#include "particles.h"
+
+static inline Uint32 particle_random(struct ParticlePool *pool) {
+    pool->rng = pool->rng * 1664525u + 1013904223u;
+    return pool->rng;
+}
+
+// Random number between 0.0 and 1.0, in steps of 1/256
+static inline ParticleScalar particle_random_fraction(struct ParticlePool *pool) {
+    static constexpr ParticleScalar step = ParticleScalar(1.0f / 256.0f);
+    return ParticleScalar((int)(particle_random(pool) >> 24)) * step;
+}
+
+void particles_init(struct ParticlePool *pool, Uint32 seed) {
+    static constexpr ParticleScalar degrees_per_direction = ParticleScalar(360.0f / PARTICLE_DIRECTIONS);
+    pool->count = 0;
+    pool->spawned_this_frame = 0;
+    pool->dropped = 0;
+    pool->rng = seed;
+    for (int i = 0; i < PARTICLE_DIRECTIONS; i++) {
+        ParticleScalar angle = ParticleScalar(i) * degrees_per_direction;
+        pool->directions[i][0] = sim_sin_deg(angle);
+        pool->directions[i][1] = -sim_cos_deg(angle);
+    }
+}
+
+void particles_begin_frame(struct ParticlePool *pool) {
+    pool->spawned_this_frame = 0;
+}
+
+// Clamp a spawn request to the free slots and what's left of this frame's budget
+static int reserve(struct ParticlePool *pool, int count) {
+    int allowed = SDL_min(count, PARTICLE_CAPACITY - pool->count);
+    allowed = SDL_min(allowed, PARTICLE_SPAWN_CAP - pool->spawned_this_frame);
+    allowed = SDL_max(allowed, 0);
+    pool->dropped += count - allowed;
+    pool->spawned_this_frame += allowed;
+    return allowed;
+}
+
+int particles_spawn_burst(struct ParticlePool *pool, ParticleScalar x, ParticleScalar y, int count, ParticleScalar speed, int lifetime, Uint32 color) {
+    static constexpr ParticleScalar slowest = ParticleScalar(0.4f);
+    static constexpr ParticleScalar spread = ParticleScalar(0.6f);
+    int n = reserve(pool, count);
+    int first = pool->count;
+    Sint32 fade_step = 65536 / SDL_max(lifetime, 1);
+    for (int i = first; i < first + n; i++) {
+        Uint32 r = particle_random(pool);
+        const ParticleScalar *dir = pool->directions[(r >> 16) % PARTICLE_DIRECTIONS];
+        // Vary speed and life a little so the burst doesn't look like a ring
+        ParticleScalar s = speed * (slowest + spread * particle_random_fraction(pool));
+        pool->x[i] = x;
+        pool->y[i] = y;
+        pool->velocity_x[i] = dir[0] * s;
+        pool->velocity_y[i] = dir[1] * s;
+        pool->life[i] = lifetime - (Sint32)((r >> 8) & 7);
+        pool->fade_step[i] = fade_step;
+        pool->color[i] = color;
+    }
+    pool->count += n;
+    return n;
+}
+
+int particles_spawn_cone(struct ParticlePool *pool, ParticleScalar x, ParticleScalar y, ParticleScalar direction, ParticleScalar spread,
+                         int count, ParticleScalar speed, int lifetime, Uint32 color) {
+    static constexpr ParticleScalar half = ParticleScalar(0.5f);
+    int n = reserve(pool, count);
+    int first = pool->count;
+    Sint32 fade_step = 65536 / SDL_max(lifetime, 1);
+    for (int i = first; i < first + n; i++) {
+        ParticleScalar angle = direction + spread * (particle_random_fraction(pool) - half);
+        ParticleScalar s = speed * (half + half * particle_random_fraction(pool));
+        pool->x[i] = x;
+        pool->y[i] = y;
+        pool->velocity_x[i] = sim_sin_deg(angle) * s;
+        pool->velocity_y[i] = -sim_cos_deg(angle) * s;
+        pool->life[i] = lifetime;
+        pool->fade_step[i] = fade_step;
+        pool->color[i] = color;
+    }
+    pool->count += n;
+    return n;
+}
+
+void particles_update(struct ParticlePool *pool, int width, int height) {
+    static constexpr ParticleScalar drag = ParticleScalar(PARTICLE_DRAG);
+    const ParticleScalar zero = ParticleScalar(0);
+    const ParticleScalar right = ParticleScalar(width);
+    const ParticleScalar bottom = ParticleScalar(height);
+    const int count = pool->count;
+    ParticleScalar *__restrict x = pool->x;
+    ParticleScalar *__restrict y = pool->y;
+    ParticleScalar *__restrict vx = pool->velocity_x;
+    ParticleScalar *__restrict vy = pool->velocity_y;
+    Sint32 *__restrict life = pool->life;
+
+    // Straight line loops over the arrays, which the compiler turns into SIMD
+    for (int i = 0; i < count; i++) {
+        x[i] += vx[i];
+        y[i] += vy[i];
+        vx[i] *= drag;
+        vy[i] *= drag;
+        life[i] -= 1;
+    }
+
+    // Remove dead particles by moving the last live one into their slot
+    int i = 0;
+    int n = count;
+    while (i < n) {
+        bool dead = life[i] <= 0 || x[i] < zero || y[i] < zero || x[i] >= right || y[i] >= bottom;
+        if (!dead) {
+            i++;
+            continue;
+        }
+        n--;
+        x[i] = x[n];
+        y[i] = y[n];
+        vx[i] = vx[n];
+        vy[i] = vy[n];
+        life[i] = life[n];
+        pool->fade_step[i] = pool->fade_step[n];
+        pool->color[i] = pool->color[n];
+    }
+    pool->count = n;
+}
+
+// Add two pixels byte by byte, clamping each byte at 255, without unpacking them
+static inline Uint32 saturating_add(Uint32 a, Uint32 b) {
+    Uint32 sum = (a & 0x7F7F7F7F) + (b & 0x7F7F7F7F);
+    Uint32 top = (a ^ b) & 0x80808080;
+    Uint32 overflow = ((a & b) | (sum & top)) & 0x80808080;
+    return (sum ^ top) | ((overflow >> 7) * 0xFF);
+}
+
+// Scale every byte of a pixel by scale/256
+static inline Uint32 scale_color(Uint32 color, Uint32 scale) {
+    Uint32 even = ((color & 0x00FF00FF) * scale >> 8) & 0x00FF00FF;
+    Uint32 odd = (((color >> 8) & 0x00FF00FF) * scale) & 0xFF00FF00;
+    return even | odd;
+}
+
+void particles_draw(const struct ParticlePool *pool, char *pixel_buf, int pitch,
+                    const Uint8 *indices, int index_pitch, Uint8 top_index) {
+    // particles_update already dropped everything off screen
+    for (int i = 0; i < pool->count; i++) {
+        int px = (int)pool->x[i];
+        int py = (int)pool->y[i];
+        if (indices && indices[py * index_pitch + px] >= top_index) {
+            continue;
+        }
+        Uint32 scale = (Uint32)(pool->life[i] * pool->fade_step[i]) >> 8;
+        Uint32 *dst = (Uint32 *)(pixel_buf + py * pitch) + px;
+        *dst = saturating_add(*dst, scale_color(pool->color[i], SDL_min(scale, 256u)));
+    }
+}
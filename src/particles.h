@@ -0,0 +1,85 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include "sim.h"
+
+// Purely cosmetic particles (explosions, thrust exhaust).
+// They live outside GameState: they don't affect gameplay, aren't part of
+// snapshots and use their own random numbers so the simulation stays deterministic.
+// They use the simulation's scalar type, so fixed-point builds for boards
+// without an FPU don't do any floating point per particle either.
+
+typedef GameSim::Scalar ParticleScalar;
+
+// Maximum live particles. Storage is fixed, nothing is allocated per frame.
+// On the device the pool has to fit in SRAM next to everything else (see
+// memory_budget.h), which still leaves room for an explosion and the exhaust.
+#ifndef PARTICLE_CAPACITY
+#if PICO_ON_DEVICE
+#define PARTICLE_CAPACITY 512
+#else
+#define PARTICLE_CAPACITY 4096
+#endif
+#endif
+
+// Maximum particles spawned per frame, so big explosions thin out instead of
+// eating the frame on slow devices
+#ifndef PARTICLE_SPAWN_CAP
+#if PICO_ON_DEVICE
+#define PARTICLE_SPAWN_CAP 128
+#else
+#define PARTICLE_SPAWN_CAP 1024
+#endif
+#endif
+
+// Velocity kept per tick, so particles slow down as they fade
+#define PARTICLE_DRAG 0.97f
+
+// Number of precomputed directions spawns pick from
+#define PARTICLE_DIRECTIONS 64
+
+// Structure of arrays so the update loop runs over contiguous values
+struct ParticlePool {
+    alignas(64) ParticleScalar x[PARTICLE_CAPACITY];
+    alignas(64) ParticleScalar y[PARTICLE_CAPACITY];
+    alignas(64) ParticleScalar velocity_x[PARTICLE_CAPACITY];
+    alignas(64) ParticleScalar velocity_y[PARTICLE_CAPACITY];
+    alignas(64) Sint32 life[PARTICLE_CAPACITY];      // Ticks left
+    alignas(64) Sint32 fade_step[PARTICLE_CAPACITY]; // 65536 / starting life, for fading
+    alignas(64) Uint32 color[PARTICLE_CAPACITY];     // Same byte order as the framebuffer
+    int count;
+    int spawned_this_frame;
+    int dropped; // Spawns refused because of the caps
+    Uint32 rng;
+    ParticleScalar directions[PARTICLE_DIRECTIONS][2];
+};
+
+void particles_init(struct ParticlePool *pool, Uint32 seed);
+
+// Reset the per frame spawn budget
+void particles_begin_frame(struct ParticlePool *pool);
+
+// Pack a color in framebuffer byte order (R, G, B, X in memory)
+static inline Uint32 particle_color(Uint8 r, Uint8 g, Uint8 b) {
+    Uint32 color;
+    Uint8 bytes[4] = { r, g, b, 0 };
+    SDL_memcpy(&color, bytes, sizeof(color));
+    return color;
+}
+
+// Spawn `count` particles flying out in all directions from (x, y).
+// Returns how many were actually spawned.
+int particles_spawn_burst(struct ParticlePool *pool, ParticleScalar x, ParticleScalar y, int count, ParticleScalar speed, int lifetime, Uint32 color);
+
+// Spawn particles in a cone around `direction` (degrees, 0 = up like the ship)
+int particles_spawn_cone(struct ParticlePool *pool, ParticleScalar x, ParticleScalar y, ParticleScalar direction, ParticleScalar spread,
+                         int count, ParticleScalar speed, int lifetime, Uint32 color);
+
+// Move all particles one tick and remove the ones that died or left the screen
+void particles_update(struct ParticlePool *pool, int width, int height);
+
+// Additively blend all particles into the framebuffer, saturating at full brightness.
+// If `indices` (the palette indices the frame was expanded from) is given, pixels
+// with an index of `top_index` or above stay on top, so the HUD stays readable.
+void particles_draw(const struct ParticlePool *pool, char *pixel_buf, int pitch,
+                    const Uint8 *indices, int index_pitch, Uint8 top_index);
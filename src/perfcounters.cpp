@@ -0,0 +1,195 @@
+#include "perfcounters.h"
+
+#ifdef PERF_COUNTERS
+
+#include "eventlog.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+static const char *counter_names[PERF_COUNTER_COUNT] = { "cycles", "instructions", "L1d misses", "LLC misses", "branch misses" };
+static const char *phase_names[PERF_PHASE_COUNT] = { "input", "sim", "effects", "draw", "render", "upload" };
+
+// The event each counter's averages are logged as
+static const LogEvent counter_events[PERF_COUNTER_COUNT] = {
+    EV_PERF_CYCLES, EV_PERF_INSTRUCTIONS, EV_PERF_L1D_MISSES, EV_PERF_LLC_MISSES, EV_PERF_BRANCH_MISSES
+};
+
+struct PerfState {
+    bool active;
+    int fds[PERF_COUNTER_COUNT]; // -1 for counters the kernel refused
+    int slots[PERF_COUNTER_COUNT]; // Position of each counter in a group read, -1 if missing
+    int slot_count;
+    Uint64 start[PERF_COUNTER_COUNT];
+    Uint64 totals[PERF_PHASE_COUNT][PERF_COUNTER_COUNT];
+    int frames;
+};
+
+static struct PerfState perf;
+
+#ifdef __linux__
+
+static int open_counter(Uint32 type, Uint64 config, int group_fd) {
+    struct perf_event_attr attr;
+    SDL_memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1; // Allowed without privileges, and it's our code we want to see
+    attr.exclude_hv = 1;
+    if (group_fd == -1) {
+        // The leader starts disabled and keeps the whole group on the PMU, or reads fail
+        attr.disabled = 1;
+        attr.pinned = 1;
+    }
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+// Current value of every counter
+static bool read_counters(Uint64 values[PERF_COUNTER_COUNT]) {
+    Uint64 buffer[1 + PERF_COUNTER_COUNT];
+    ssize_t size = sizeof(Uint64) * (1 + perf.slot_count);
+    if (read(perf.fds[PERF_CYCLES], buffer, size) != size || buffer[0] != (Uint64)perf.slot_count) {
+        return false;
+    }
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        values[c] = perf.slots[c] >= 0 ? buffer[1 + perf.slots[c]] : 0;
+    }
+    return true;
+}
+
+bool perf_init() {
+    const struct { Uint32 type; Uint64 config; } events[PERF_COUNTER_COUNT] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    SDL_memset(&perf, 0, sizeof(perf));
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        perf.fds[c] = -1;
+        perf.slots[c] = -1;
+    }
+
+    // Cycles lead the group, without them there is nothing to report
+    perf.fds[PERF_CYCLES] = open_counter(events[PERF_CYCLES].type, events[PERF_CYCLES].config, -1);
+    if (perf.fds[PERF_CYCLES] < 0) {
+        SDL_Log("Hardware performance counters unavailable: %s", strerror(errno));
+        return false;
+    }
+    perf.slots[PERF_CYCLES] = perf.slot_count++;
+
+    // The rest are optional, virtual PMUs often lack the cache events
+    for (int c = PERF_CYCLES + 1; c < PERF_COUNTER_COUNT; c++) {
+        perf.fds[c] = open_counter(events[c].type, events[c].config, perf.fds[PERF_CYCLES]);
+        if (perf.fds[c] < 0) {
+            SDL_Log("Performance counter %s unavailable: %s", counter_names[c], strerror(errno));
+            continue;
+        }
+        perf.slots[c] = perf.slot_count++;
+    }
+
+    ioctl(perf.fds[PERF_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(perf.fds[PERF_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    // A pinned group that can't be scheduled reads nothing
+    if (!read_counters(perf.start)) {
+        SDL_Log("Hardware performance counters can't be scheduled, disabling them");
+        perf_shutdown();
+        return false;
+    }
+
+    // Reports go through the event log, which prints them off the frame thread
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        eventlog_set_labels(counter_events[c], phase_names, PERF_PHASE_COUNT);
+    }
+    eventlog_set_labels(EV_PERF_IPC, phase_names, PERF_PHASE_COUNT);
+
+    perf.active = true;
+    SDL_Log("Hardware performance counters enabled (%d of %d), reporting every %d frames", perf.slot_count, PERF_COUNTER_COUNT, PERF_REPORT_FRAMES);
+    return true;
+}
+
+void perf_shutdown() {
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (perf.fds[c] >= 0) {
+            close(perf.fds[c]);
+            perf.fds[c] = -1;
+        }
+    }
+    perf.active = false;
+}
+
+#else
+
+bool perf_init() {
+    SDL_Log("Hardware performance counters are only supported on Linux");
+    perf.active = false;
+    return false;
+}
+
+void perf_shutdown() {
+}
+
+static bool read_counters(Uint64 values[PERF_COUNTER_COUNT]) {
+    (void)values;
+    return false;
+}
+
+#endif
+
+void perf_phase_begin(PerfPhase phase) {
+    (void)phase;
+    if (perf.active && !read_counters(perf.start)) {
+        perf_shutdown();
+    }
+}
+
+void perf_phase_end(PerfPhase phase) {
+    if (!perf.active) {
+        return;
+    }
+    Uint64 now[PERF_COUNTER_COUNT];
+    if (!read_counters(now)) {
+        perf_shutdown();
+        return;
+    }
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        perf.totals[phase][c] += now[c] - perf.start[c];
+    }
+}
+
+void perf_frame_end() {
+    if (!perf.active || ++perf.frames < PERF_REPORT_FRAMES) {
+        return;
+    }
+
+    // Only push records here, the event log thread formats and prints them.
+    // Counters the kernel refused were reported by perf_init and are left out.
+    LOG_INFO(EV_PERF_REPORT, perf.frames, 0);
+    for (int p = 0; p < PERF_PHASE_COUNT; p++) {
+        const Uint64 *totals = perf.totals[p];
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            if (perf.slots[c] >= 0) {
+                LOG_INFO(counter_events[c], p, (Sint32)SDL_min(totals[c] / perf.frames, (Uint64)SDL_MAX_SINT32));
+            }
+        }
+        if (perf.slots[PERF_INSTRUCTIONS] >= 0 && totals[PERF_CYCLES]) {
+            LOG_INFO(EV_PERF_IPC, p, (Sint32)(totals[PERF_INSTRUCTIONS] * 100 / totals[PERF_CYCLES]));
+        }
+    }
+
+    SDL_memset(perf.totals, 0, sizeof(perf.totals));
+    perf.frames = 0;
+}
+
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Hardware performance counters per frame phase.
+// Built with PERF_COUNTERS defined (the ASTEROIDS_PERF_COUNTERS CMake option)
+// this reads cycles, instructions, cache and branch misses around each phase
+// through Linux perf_event_open, and logs per frame averages through the
+// event log every PERF_REPORT_FRAMES frames. Without it, or when the kernel
+// won't give us counters (containers, VMs, perf_event_paranoid), every call
+// does nothing.
+
+// Frames per report
+#define PERF_REPORT_FRAMES 300
+
+enum PerfPhase {
+    PERF_INPUT,   // Reading the controller
+    PERF_SIM,     // Recording history and simulating the tick
+    PERF_EFFECTS, // Spawning and moving particles
+    PERF_DRAW,    // Recording the display list
+    PERF_RENDER,  // Display list, palette expansion, particles and upscaling
+    PERF_UPLOAD,  // Texture upload
+    PERF_PHASE_COUNT
+};
+
+enum PerfCounter {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_COUNTER_COUNT
+};
+
+#ifdef PERF_COUNTERS
+
+// Open the counters. Returns false (and logs why) if none are available.
+bool perf_init();
+void perf_shutdown();
+
+void perf_phase_begin(PerfPhase phase);
+void perf_phase_end(PerfPhase phase);
+
+// Count a frame, and log the averages when a report is due
+void perf_frame_end();
+
+#define PERF_BEGIN(phase) perf_phase_begin(phase)
+#define PERF_END(phase) perf_phase_end(phase)
+
+#else
+
+static inline bool perf_init() { return false; }
+static inline void perf_shutdown() {}
+static inline void perf_frame_end() {}
+
+#define PERF_BEGIN(phase) ((void)0)
+#define PERF_END(phase) ((void)0)
+
+#endif
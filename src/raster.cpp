@@ -0,0 +1,244 @@
+#include "raster.h"
+
+// Cohen–Sutherland region codes
+#define OUT_LEFT 1
+#define OUT_RIGHT 2
+#define OUT_TOP 4
+#define OUT_BOTTOM 8
+
+static inline int outcode(const struct RasterTarget *target, int x, int y) {
+    int code = 0;
+    if (x < 0) code |= OUT_LEFT;
+    else if (x >= target->width) code |= OUT_RIGHT;
+    if (y < 0) code |= OUT_TOP;
+    else if (y >= target->height) code |= OUT_BOTTOM;
+    return code;
+}
+
+// Offset along the minor axis at step i of a line that takes n steps along its
+// major axis and moves d (0 <= d <= n) along the minor one. Halves round up.
+static inline int minor_offset(int i, int d, int n) {
+    return (int)((2 * (Sint64)i * d + n) / (2 * (Sint64)n));
+}
+
+// Smallest i in [lo, hi] for which pred(i) holds, or hi + 1.
+// pred must be false up to some point and true after it.
+template <typename Pred>
+static int first_true(int lo, int hi, Pred pred) {
+    int end = hi + 1;
+    while (lo < end) {
+        int mid = lo + (end - lo) / 2;
+        if (pred(mid)) {
+            end = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return end;
+}
+
+void raster_line(const struct RasterTarget *target, int x0, int y0, int x1, int y1, Uint8 color) {
+    // Both ends beyond the same edge, nothing to draw
+    if (outcode(target, x0, y0) & outcode(target, x1, y1)) {
+        return;
+    }
+
+    // Walk along the longer ("major") axis, the other one is the minor axis
+    int dx = x1 - x0;
+    int dy = y1 - y0;
+    bool x_major = SDL_abs(dx) >= SDL_abs(dy);
+    int n = SDL_max(SDL_abs(dx), SDL_abs(dy));
+    int d = SDL_min(SDL_abs(dx), SDL_abs(dy));
+    int major0 = x_major ? x0 : y0;
+    int minor0 = x_major ? y0 : x0;
+    int major_step = ((x_major ? dx : dy) < 0) ? -1 : 1;
+    int minor_step = ((x_major ? dy : dx) < 0) ? -1 : 1;
+    int major_limit = x_major ? target->width : target->height;
+    int minor_limit = x_major ? target->height : target->width;
+
+    if (n == 0) {
+        if (!outcode(target, x0, y0)) {
+            target->pixels[y0 * target->pitch + x0] = color;
+        }
+        return;
+    }
+
+    // Clip: the steps where the major coordinate is on the target...
+    int first, last;
+    if (major_step > 0) {
+        first = SDL_max(0, -major0);
+        last = SDL_min(n, major_limit - 1 - major0);
+    } else {
+        first = SDL_max(0, major0 - (major_limit - 1));
+        last = SDL_min(n, major0);
+    }
+    if (first > last) {
+        return;
+    }
+
+    // ...narrowed down to where the minor one is too. It only moves one way,
+    // so that is a single range as well.
+    auto minor_at = [&](int i) { return minor0 + minor_step * minor_offset(i, d, n); };
+    auto entered = [&](int i) { return minor_step > 0 ? minor_at(i) >= 0 : minor_at(i) < minor_limit; };
+    auto left = [&](int i) { return minor_step > 0 ? minor_at(i) >= minor_limit : minor_at(i) < 0; };
+    first = first_true(first, last, entered);
+    last = first_true(first, last, left) - 1;
+    if (first > last) {
+        return;
+    }
+
+    // Step through the visible part, carrying the rounding remainder like Bresenham
+    Sint64 numerator = 2 * (Sint64)first * d + n;
+    int remainder = (int)(numerator % (2 * n));
+    int major_pitch = x_major ? major_step : major_step * target->pitch;
+    int minor_pitch = x_major ? minor_step * target->pitch : minor_step;
+    int x = x_major ? major0 + major_step * first : minor_at(first);
+    int y = x_major ? minor_at(first) : major0 + major_step * first;
+    Uint8 *p = target->pixels + y * target->pitch + x;
+    for (int i = first; i <= last; i++) {
+        *p = color;
+        p += major_pitch;
+        remainder += 2 * d;
+        if (remainder >= 2 * n) {
+            remainder -= 2 * n;
+            p += minor_pitch;
+        }
+    }
+}
+
+void raster_polygon_outline(const struct RasterTarget *target, const struct RasterPoint *points, int count, Uint8 color) {
+    for (int i = 0; i < count; i++) {
+        const struct RasterPoint *a = &points[i];
+        const struct RasterPoint *b = &points[(i + 1) % count];
+        raster_line(target, a->x, a->y, b->x, b->y, color);
+    }
+}
+
+// Fill x0..x1 (inclusive) of row y, clipped horizontally
+static inline void fill_span(const struct RasterTarget *target, int y, int x0, int x1, Uint8 color) {
+    x0 = SDL_max(x0, 0);
+    x1 = SDL_min(x1, target->width - 1);
+    if (x0 <= x1) {
+        SDL_memset(target->pixels + y * target->pitch + x0, color, x1 - x0 + 1);
+    }
+}
+
+static inline Sint64 ceil_div(Sint64 a, Sint64 b) {
+    // b > 0
+    Sint64 q = a / b;
+    return (a % b > 0) ? q + 1 : q;
+}
+
+void raster_polygon_fill(const struct RasterTarget *target, const struct RasterPoint *points, int count, Uint8 color) {
+    if (count < 3 || count > RASTER_MAX_POINTS) {
+        return;
+    }
+    int min_y = points[0].y;
+    int max_y = points[0].y;
+    for (int i = 1; i < count; i++) {
+        min_y = SDL_min(min_y, points[i].y);
+        max_y = SDL_max(max_y, points[i].y);
+    }
+
+    // Rows whose pixel centers (y + 0.5) are between the top and bottom points
+    int row_start = SDL_max(min_y, 0);
+    int row_end = SDL_min(max_y - 1, target->height - 1);
+    for (int y = row_start; y <= row_end; y++) {
+        // First pixel right of where each edge crosses this row's centers
+        int crossings[RASTER_MAX_POINTS];
+        int crossing_count = 0;
+        for (int i = 0; i < count; i++) {
+            const struct RasterPoint *a = &points[i];
+            const struct RasterPoint *b = &points[(i + 1) % count];
+            if (a->y == b->y) {
+                continue;
+            }
+            const struct RasterPoint *top = (a->y < b->y) ? a : b;
+            const struct RasterPoint *bottom = (a->y < b->y) ? b : a;
+            if (y < top->y || y >= bottom->y) {
+                continue;
+            }
+            // The edge crosses y + 0.5 at x = cross / (2 * h), the first pixel
+            // whose center is at or right of that is ceil((cross - h) / (2 * h))
+            Sint64 h = bottom->y - top->y;
+            Sint64 cross = 2 * (Sint64)top->x * h + (Sint64)(2 * (y - top->y) + 1) * (bottom->x - top->x);
+            int x = (int)ceil_div(cross - h, 2 * h);
+
+            // Keep them sorted as they come in, there are only a few
+            int k = crossing_count++;
+            while (k > 0 && crossings[k - 1] > x) {
+                crossings[k] = crossings[k - 1];
+                k--;
+            }
+            crossings[k] = x;
+        }
+
+        for (int k = 0; k + 1 < crossing_count; k += 2) {
+            fill_span(target, y, crossings[k], crossings[k + 1] - 1, color);
+        }
+    }
+}
+
+// Integer square root, rounded down
+static int isqrt(Uint32 v) {
+    Uint32 result = 0;
+    Uint32 bit = 1u << 30;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= result + bit) {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (int)result;
+}
+
+// Half the width of row dy of a disc, or -1 if the row is outside it
+static inline int disc_half_width(int radius, int dy) {
+    Sint64 left = (Sint64)radius * radius + radius - (Sint64)dy * dy;
+    return left < 0 ? -1 : isqrt((Uint32)left);
+}
+
+// Rows dy of a circle that are on the target
+static inline bool circle_rows(const struct RasterTarget *target, int cx, int cy, int radius, int *dy_start, int *dy_end) {
+    if (radius < 0 || cx + radius < 0 || cx - radius >= target->width) {
+        return false;
+    }
+    *dy_start = SDL_max(-radius, -cy);
+    *dy_end = SDL_min(radius, target->height - 1 - cy);
+    return *dy_start <= *dy_end;
+}
+
+void raster_circle_fill(const struct RasterTarget *target, int cx, int cy, int radius, Uint8 color) {
+    int dy_start, dy_end;
+    if (!circle_rows(target, cx, cy, radius, &dy_start, &dy_end)) {
+        return;
+    }
+    for (int dy = dy_start; dy <= dy_end; dy++) {
+        int w = disc_half_width(radius, dy);
+        fill_span(target, cy + dy, cx - w, cx + w, color);
+    }
+}
+
+void raster_circle_outline(const struct RasterTarget *target, int cx, int cy, int radius, Uint8 color) {
+    int dy_start, dy_end;
+    if (!circle_rows(target, cx, cy, radius, &dy_start, &dy_end)) {
+        return;
+    }
+    for (int dy = dy_start; dy <= dy_end; dy++) {
+        int w = disc_half_width(radius, dy);
+        // Pixels whose four neighbours are all in the disc are inside, the rest of the row is outline
+        int inner = SDL_min(w - 1, SDL_min(disc_half_width(radius, dy - 1), disc_half_width(radius, dy + 1)));
+        if (inner < 0) {
+            fill_span(target, cy + dy, cx - w, cx + w, color);
+        } else {
+            fill_span(target, cy + dy, cx - w, cx - inner - 1, color);
+            fill_span(target, cy + dy, cx + inner + 1, cx + w, color);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Primitive rasterization into a buffer of palette indices.
+// Every primitive is clipped against the target once, up front, and then
+// writes its pixels (or whole spans of them) without further checks.
+//
+// Pixel rules, which the reference rasterizers in bench.cpp follow as well:
+// - Lines step along their longer axis and round the other coordinate to the
+//   nearest pixel, halves away from the start point. Both end points are drawn.
+// - Filled polygons cover the pixels whose centers are inside (even-odd rule).
+//   A center exactly on a left edge is inside, exactly on a right edge outside.
+// - Filled circles cover the pixels with dx*dx + dy*dy <= r*r + r from the
+//   center, and outlines are the pixels of that disc next to one outside it.
+
+// Most points a polygon can have
+#define RASTER_MAX_POINTS 32
+
+struct RasterTarget {
+    Uint8 *pixels;
+    int pitch;
+    int width;
+    int height;
+};
+
+struct RasterPoint {
+    int x;
+    int y;
+};
+
+void raster_line(const struct RasterTarget *target, int x0, int y0, int x1, int y1, Uint8 color);
+
+// Closed outline through `count` points
+void raster_polygon_outline(const struct RasterTarget *target, const struct RasterPoint *points, int count, Uint8 color);
+void raster_polygon_fill(const struct RasterTarget *target, const struct RasterPoint *points, int count, Uint8 color);
+
+static inline void raster_triangle_outline(const struct RasterTarget *target, struct RasterPoint a, struct RasterPoint b, struct RasterPoint c, Uint8 color) {
+    const struct RasterPoint points[3] = { a, b, c };
+    raster_polygon_outline(target, points, 3, color);
+}
+
+static inline void raster_triangle_fill(const struct RasterTarget *target, struct RasterPoint a, struct RasterPoint b, struct RasterPoint c, Uint8 color) {
+    const struct RasterPoint points[3] = { a, b, c };
+    raster_polygon_fill(target, points, 3, color);
+}
+
+void raster_circle_outline(const struct RasterTarget *target, int cx, int cy, int radius, Uint8 color);
+void raster_circle_fill(const struct RasterTarget *target, int cx, int cy, int radius, Uint8 color);
@@ -0,0 +1,619 @@
+#pragma once
+
+#include "game_config.h"
+#include "fixed.h"
+#include "eventlog.h"
+#include <cmath>
+
+// Game simulation, templated on the numeric types it runs with.
+// FloatSim is what desktop builds use. FixedSim avoids floating point in the
+// per-tick math for microcontrollers without an FPU. It uses Q16.16 for
+// positions and angles, and Q2.14 for asteroid and bullet velocities (they
+// never exceed 0.3 pixels per tick), which shrinks those structs. The
+// player's velocity is Q8.24: friction takes 0.5% of it every tick, and with
+// 16 fractional bits that rounds to nothing below 0.0015 pixels per tick, so
+// the ship would never come to rest.
+struct FloatSim {
+    typedef float Scalar;
+    typedef float Position;
+    typedef float Velocity;
+    typedef float PlayerVelocity;
+};
+
+struct FixedSim {
+    typedef Q16_16 Scalar;
+    typedef Q16_16 Position;
+    typedef Q2_14 Velocity;
+    typedef Q8_24 PlayerVelocity;
+};
+
+// The simulation the game itself runs, chosen with the ASTEROIDS_FIXED_POINT CMake option
+#ifdef SIM_FIXED_POINT
+typedef FixedSim GameSim;
+#else
+typedef FloatSim GameSim;
+#endif
+
+struct EVENTS {
+
+    bool left_flag;
+    bool right_flag;
+
+    bool shoot_flag;
+    bool thrust_flag;
+
+};
+
+// Player state
+template <typename Sim>
+struct PlayerT {
+    typename Sim::Position x;
+    typename Sim::Position y;
+    // Friction is applied to these every tick, so they keep extra precision
+    typename Sim::PlayerVelocity velocity_x;
+    typename Sim::PlayerVelocity velocity_y;
+    typename Sim::Scalar rotation; // in degrees
+    int lives;
+    int score;
+    bool invulnerable; // Flag to indicate invulnerability period
+    int invulnerable_timer; // Timer for invulnerability period
+    int shot_cooldown; // Ticks until the ship can shoot again
+};
+
+template <typename Sim>
+struct AsteroidT {
+    typename Sim::Position x;
+    typename Sim::Position y;
+    Sint16 width;
+    Sint16 height;
+    typename Sim::Velocity speed_x;
+    typename Sim::Velocity speed_y;
+};
+
+template <typename Sim>
+struct BulletT {
+    typename Sim::Position x;
+    typename Sim::Position y;
+    typename Sim::Velocity velocity_x;
+    typename Sim::Velocity velocity_y;
+    Sint16 lifetime; // Timer for how long the bullet exists
+    bool active;
+};
+
+// Everything the simulation reads and writes, in one trivially copyable block
+// so it can be snapshotted with a memcpy (see snapshot.h).
+// bullets must stay last: snapshots only copy the first bullet_count of them.
+template <typename Sim>
+struct GameState {
+    PlayerT<Sim> player;
+    AsteroidT<Sim> asteroids[MAX_ASTEROIDS];
+    int asteroid_count;
+    int bullet_count;
+    unsigned long rng; // State of the LCG below
+    Uint32 tick; // Number of ticks simulated
+    bool game_over;
+    int game_over_timer;
+    // Where bullets hit asteroids during the last tick, for effects
+    struct { typename Sim::Position x, y; } hits[MAX_HITS_PER_TICK];
+    int hit_count;
+    BulletT<Sim> bullets[MAX_BULLETS];
+};
+
+// Custom random number generator using Linear Congruential Generator (LCG)
+// These constants are from Numerical Recipes
+static const unsigned long lcg_a = 1664525;
+static const unsigned long lcg_c = 1013904223;
+static const unsigned long lcg_m = 4294967295; // 2^32 - 1
+
+// Generate a random number between 0 and m-1
+static inline unsigned long random_next(unsigned long *state) {
+    *state = (lcg_a * *state + lcg_c) % lcg_m;
+    return *state;
+}
+
+// Generate a random number between min and max (inclusive)
+static inline int random_range(unsigned long *state, int min, int max) {
+    return min + (random_next(state) % (max - min + 1));
+}
+
+// Generate a random float between 0.0 and 1.0
+static inline float random_float(unsigned long *state) {
+    return (float)random_next(state) / lcg_m;
+}
+
+// Function to generate a random speed within a range
+static inline float generate_random_speed(unsigned long *state) {
+    // Generate a random float between -0.03 and 0.03
+    // This ensures asteroids can travel in different directions
+    // with a minimum absolute speed of 0.01
+    float speed = (random_float(state) * 0.06f) - 0.03f;
+
+    // Ensure minimum speed in either direction
+    if (speed > 0 && speed < 0.01f) {
+        speed = 0.01f;
+    } else if (speed < 0 && speed > -0.01f) {
+        speed = -0.01f;
+    }
+
+    return speed;
+}
+
+// Trig on angles in degrees for either kind of scalar
+static inline float sim_sin_deg(float degrees) {
+    return sin(degrees * M_PI / 180.0f);
+}
+
+static inline float sim_cos_deg(float degrees) {
+    return cos(degrees * M_PI / 180.0f);
+}
+
+template <typename Storage, int Frac>
+static inline Fixed<Storage, Frac> sim_sin_deg(Fixed<Storage, Frac> degrees) {
+    return fixed_sin_deg(degrees);
+}
+
+template <typename Storage, int Frac>
+static inline Fixed<Storage, Frac> sim_cos_deg(Fixed<Storage, Frac> degrees) {
+    return fixed_cos_deg(degrees);
+}
+
+// Whether (dx, dy) is shorter than radius. Checking each axis first keeps the
+// squares small enough for Q16.16 and skips the multiplies for far apart objects.
+template <typename T>
+static inline bool sim_closer_than(T dx, T dy, int radius) {
+    const T r = T(radius);
+    if (dx >= r || dx <= -r || dy >= r || dy <= -r) {
+        return false;
+    }
+    return dx * dx + dy * dy < r * r;
+}
+
+// Function to initialize an asteroid
+template <typename Sim>
+void sim_spawn_asteroid(GameState<Sim> *g, int x, int y, int width, int height, float speed_x, float speed_y) {
+    // Check if we have room for another asteroid
+    if (g->asteroid_count >= MAX_ASTEROIDS) {
+        return; // No more room
+    }
+
+    // Speeds are only converted here, at spawn time, never per tick
+    AsteroidT<Sim> *a = &g->asteroids[g->asteroid_count];
+    a->x = typename Sim::Position(x);
+    a->y = typename Sim::Position(y);
+    a->width = width;
+    a->height = height;
+    a->speed_x = typename Sim::Velocity(speed_x);
+    a->speed_y = typename Sim::Velocity(speed_y);
+
+    // Increment the asteroid count
+    g->asteroid_count++;
+}
+
+// Spawn a full set of asteroids at random positions
+template <typename Sim>
+void sim_spawn_asteroids(GameState<Sim> *g) {
+    g->asteroid_count = 0;
+    for (int i = 0; i < MAX_ASTEROIDS; i++) {
+        int rand_x = random_range(&g->rng, 1, WIDTH - 10);
+        int rand_y = random_range(&g->rng, 1, HEIGHT - 10);
+        float rand_speed_x = generate_random_speed(&g->rng);
+        float rand_speed_y = generate_random_speed(&g->rng);
+        sim_spawn_asteroid(g, rand_x, rand_y, 10, 10, rand_speed_x, rand_speed_y);
+    }
+}
+
+// Put the player back in the middle of the screen
+template <typename Sim>
+void sim_reset_player(GameState<Sim> *g, int lives) {
+    PlayerT<Sim> *p = &g->player;
+    p->x = typename Sim::Position(WIDTH / 2);
+    p->y = typename Sim::Position(HEIGHT / 2);
+    p->velocity_x = typename Sim::PlayerVelocity(0);
+    p->velocity_y = typename Sim::PlayerVelocity(0);
+    p->rotation = typename Sim::Scalar(0);
+    p->lives = lives;
+    p->score = 0;
+    p->invulnerable = false;
+    p->invulnerable_timer = 0;
+    p->shot_cooldown = 0;
+}
+
+// Runs once at startup
+template <typename Sim>
+void sim_init(GameState<Sim> *g, unsigned long seed) {
+    g->rng = seed;
+    g->tick = 0;
+    g->game_over = false;
+    g->game_over_timer = 0;
+    g->hit_count = 0;
+    sim_reset_player(g, 5);
+    g->bullet_count = 0;
+    sim_spawn_asteroids(g);
+}
+
+// Start a new round after game over
+template <typename Sim>
+void sim_restart(GameState<Sim> *g) {
+    sim_reset_player(g, 3);
+    sim_spawn_asteroids(g);
+    g->bullet_count = 0;
+}
+
+// Function to create a bullet
+template <typename Sim>
+void sim_create_bullet(GameState<Sim> *g, typename Sim::Position x, typename Sim::Position y, typename Sim::Scalar rotation) {
+    typedef typename Sim::Scalar Scalar;
+
+    // Check if we have room for another bullet
+    if (g->bullet_count >= MAX_BULLETS) {
+        return; // No more room
+    }
+
+    // Calculate bullet velocity (faster than player)
+    static constexpr Scalar bullet_speed = Scalar(0.3f);
+
+    // Initialize the bullet
+    BulletT<Sim> *b = &g->bullets[g->bullet_count];
+    b->x = x;
+    b->y = y;
+    b->velocity_x = typename Sim::Velocity(sim_sin_deg(rotation) * bullet_speed);
+    b->velocity_y = typename Sim::Velocity(-sim_cos_deg(rotation) * bullet_speed);
+    b->active = true;
+    b->lifetime = 240; // Bullet will disappear after 240 frames (about 4 seconds at 60 FPS)
+
+    // Increment the bullet count
+    g->bullet_count++;
+    TELEMETRY(EV_SHOT, g->bullet_count, 0);
+}
+
+template <typename Sim>
+void sim_rotate_player(GameState<Sim> *g, int direction) {
+    typedef typename Sim::Scalar Scalar;
+    static constexpr Scalar step = Scalar(ROTATION_SPEED);
+
+    PlayerT<Sim> *p = &g->player;
+    p->rotation += (direction < 0) ? -step : step;
+
+    // Keep the angle in [0, 360) so it can't overflow fixed-point or lose float precision
+    if (p->rotation >= Scalar(360)) {
+        p->rotation -= Scalar(360);
+    } else if (p->rotation < Scalar(0)) {
+        p->rotation += Scalar(360);
+    }
+}
+
+// Apply thrust in the direction the ship is facing
+template <typename Sim>
+void sim_thrust_player(GameState<Sim> *g) {
+    typedef typename Sim::PlayerVelocity PlayerVelocity;
+    static constexpr PlayerVelocity thrust = PlayerVelocity(THRUST_ACCELERATION);
+
+    PlayerT<Sim> *p = &g->player;
+    p->velocity_x += PlayerVelocity(sim_sin_deg(p->rotation)) * thrust;
+    p->velocity_y -= PlayerVelocity(sim_cos_deg(p->rotation)) * thrust;
+}
+
+// Create a bullet at the front of the ship
+template <typename Sim>
+void sim_player_shoot(GameState<Sim> *g) {
+    typedef typename Sim::Scalar Scalar;
+    typedef typename Sim::Position Position;
+    static constexpr Scalar ship_size = Scalar(8.0f); // Same as in draw_player
+
+    PlayerT<Sim> *p = &g->player;
+    Position bullet_x = p->x + Position(sim_sin_deg(p->rotation) * ship_size);
+    Position bullet_y = p->y - Position(sim_cos_deg(p->rotation) * ship_size);
+    sim_create_bullet(g, bullet_x, bullet_y, p->rotation);
+}
+
+// Input is held state sampled every tick, so rotation and thrust are per tick
+// amounts and holding shoot fires every SHOT_COOLDOWN_TICKS
+template <typename Sim>
+void sim_handle_events(GameState<Sim> *g, const EVENTS *key_events) {
+    if (key_events->left_flag) {
+        sim_rotate_player(g, -1);
+        LOG_DEBUG(EV_ROTATE_LEFT, 0, 0);
+    }
+    if (key_events->right_flag) {
+        sim_rotate_player(g, 1);
+        LOG_DEBUG(EV_ROTATE_RIGHT, 0, 0);
+    }
+    if (key_events->thrust_flag) {
+        sim_thrust_player(g);
+        LOG_DEBUG(EV_THRUST, 0, 0);
+    }
+    if (g->player.shot_cooldown > 0) {
+        g->player.shot_cooldown--;
+    }
+    if (key_events->shoot_flag && g->player.shot_cooldown == 0) {
+        sim_player_shoot(g);
+        g->player.shot_cooldown = SHOT_COOLDOWN_TICKS;
+    }
+}
+
+template <typename Sim>
+void sim_move_asteroid(AsteroidT<Sim> *myAsteroid) {
+    typedef typename Sim::Position Position;
+
+    // Update the asteroid's position based on its speed
+    myAsteroid->x += Position(myAsteroid->speed_x);
+    myAsteroid->y += Position(myAsteroid->speed_y);
+
+    // Handle wrapping around the screen horizontally
+    if (myAsteroid->x > Position(WIDTH)) {
+        // If the asteroid goes off the right edge, wrap to the left
+        myAsteroid->x = Position(0);
+    } else if (myAsteroid->x + Position(myAsteroid->width) < Position(0)) {
+        // If the asteroid goes off the left edge, wrap to the right
+        myAsteroid->x = Position(WIDTH);
+    }
+
+    // Handle wrapping around the screen vertically
+    // Check if the asteroid is completely below the screen
+    if (myAsteroid->y + Position(myAsteroid->height) > Position(HEIGHT)) {
+        // Wrap to the top of the screen
+        myAsteroid->speed_y = -myAsteroid->speed_y;
+    }
+    // Check if the asteroid is completely above the screen
+    else if (myAsteroid->y < Position(0)) {
+        // Wrap to the bottom of the screen
+        myAsteroid->speed_y = -myAsteroid->speed_y;
+    }
+}
+
+// Function to update bullets
+template <typename Sim>
+void sim_update_bullets(GameState<Sim> *g) {
+    typedef typename Sim::Position Position;
+
+    for (int i = 0; i < g->bullet_count; i++) {
+        BulletT<Sim> *b = &g->bullets[i];
+        if (!b->active) continue;
+
+        // Update bullet position
+        b->x += Position(b->velocity_x);
+        b->y += Position(b->velocity_y);
+
+        // Decrease lifetime
+        b->lifetime--;
+
+        // Check if bullet has expired
+        if (b->lifetime <= 0) {
+            b->active = false;
+            continue;
+        }
+
+        // Handle wrapping around the screen
+        if (b->x > Position(WIDTH)) {
+            b->x = Position(0);
+        } else if (b->x < Position(0)) {
+            b->x = Position(WIDTH);
+        }
+
+        if (b->y > Position(HEIGHT)) {
+            b->y = Position(0);
+            b->lifetime = 0;
+        } else if (b->y < Position(0)) {
+            b->y = Position(HEIGHT);
+            b->lifetime = 0;
+        }
+    }
+}
+
+// Remove bullets that expired or hit something by moving the last bullet into
+// their slot, so slots are reused and snapshots only copy live bullets
+template <typename Sim>
+void sim_compact_bullets(GameState<Sim> *g) {
+    int i = 0;
+    while (i < g->bullet_count) {
+        if (g->bullets[i].active) {
+            i++;
+            continue;
+        }
+        g->bullet_count--;
+        g->bullets[i] = g->bullets[g->bullet_count];
+    }
+}
+
+// Function to check for bullet-asteroid collisions
+template <typename Sim>
+void sim_check_bullet_collisions(GameState<Sim> *g) {
+    typedef typename Sim::Position Position;
+
+    for (int i = 0; i < g->bullet_count; i++) {
+        BulletT<Sim> *b = &g->bullets[i];
+        if (!b->active) continue;
+
+        for (int j = 0; j < g->asteroid_count; j++) {
+            AsteroidT<Sim> *a = &g->asteroids[j];
+
+            // Simple collision detection
+            if (sim_closer_than(b->x - a->x, b->y - a->y, 10)) { // Collision detected
+                // Deactivate the bullet
+                b->active = false;
+
+                // Increment score
+                g->player.score += 10;
+                TELEMETRY(EV_HIT, g->player.score, 0);
+
+                // Remember where it happened so the frontend can draw an explosion
+                if (g->hit_count < MAX_HITS_PER_TICK) {
+                    g->hits[g->hit_count].x = a->x;
+                    g->hits[g->hit_count].y = a->y;
+                    g->hit_count++;
+                }
+
+                // Respawn the asteroid in a new position far from the player
+                int new_x = 0, new_y = 0;
+                bool valid_position = false;
+
+                // Try to find a position that's far from the player
+                for (int attempts = 0; attempts < 10; attempts++) {
+                    new_x = random_range(&g->rng, 1, WIDTH - 10);
+                    new_y = random_range(&g->rng, 1, HEIGHT - 10);
+
+                    // If the new position is far enough from the player, use it
+                    if (!sim_closer_than(Position(new_x) - g->player.x, Position(new_y) - g->player.y, 50)) {
+                        valid_position = true;
+                        break;
+                    }
+                }
+
+                // If we couldn't find a valid position, just use a random one
+                if (!valid_position) {
+                    new_x = random_range(&g->rng, 1, WIDTH - 10);
+                    new_y = random_range(&g->rng, 1, HEIGHT - 10);
+                }
+
+                // Update asteroid position and speed
+                a->x = Position(new_x);
+                a->y = Position(new_y);
+                a->speed_x = typename Sim::Velocity(generate_random_speed(&g->rng));
+                a->speed_y = typename Sim::Velocity(generate_random_speed(&g->rng));
+
+                // Break out of the inner loop since this bullet is now inactive
+                break;
+            }
+        }
+    }
+}
+
+// One tick of gameplay (everything except the game over screen)
+template <typename Sim>
+void sim_step(GameState<Sim> *g, const EVENTS *key_events) {
+    typedef typename Sim::PlayerVelocity PlayerVelocity;
+    typedef typename Sim::Position Position;
+    static constexpr PlayerVelocity friction = PlayerVelocity(FRICTION);
+    static constexpr PlayerVelocity bounce = PlayerVelocity(0.5f);
+
+    sim_handle_events(g, key_events);
+
+    PlayerT<Sim> *player = &g->player;
+
+    // Update player position
+    player->x += Position(player->velocity_x);
+    player->y += Position(player->velocity_y);
+
+    // Apply friction
+    player->velocity_x = player->velocity_x * friction;
+    player->velocity_y = player->velocity_y * friction;
+
+    // Handle player wrapping around the screen horizontally
+    if (player->x > Position(WIDTH)) {
+        player->x = Position(0);
+    } else if (player->x < Position(0)) {
+        player->x = Position(WIDTH);
+    }
+
+    // Prevent player from going off the screen vertically
+    // Add a small margin to account for the player's size
+    const int player_margin = 10;
+    if (player->y > Position(HEIGHT - player_margin)) {
+        player->y = Position(HEIGHT - player_margin);
+        // Bounce off the bottom by reversing vertical velocity
+        player->velocity_y = -player->velocity_y * bounce;
+    } else if (player->y < Position(player_margin)) {
+        player->y = Position(player_margin);
+        // Bounce off the top by reversing vertical velocity
+        player->velocity_y = -player->velocity_y * bounce;
+    }
+
+    // Update invulnerability timer
+    if (player->invulnerable) {
+        player->invulnerable_timer--;
+        if (player->invulnerable_timer <= 0) {
+            player->invulnerable = false;
+        }
+    }
+
+    // Move all asteroids
+    for (int i = 0; i < g->asteroid_count; i++) {
+        sim_move_asteroid(&g->asteroids[i]);
+
+        // Check for collision with player
+        if (!player->invulnerable) {
+            if (sim_closer_than(player->x - g->asteroids[i].x, player->y - g->asteroids[i].y, 10)) { // Simple collision detection
+                player->lives--;
+                TELEMETRY(EV_LIFE_LOST, player->lives, 0);
+
+                // Set invulnerability period (1000 frames)
+                player->invulnerable = true;
+                player->invulnerable_timer = 1000;
+
+                // Break out of the loop to prevent multiple collisions in the same frame
+                break;
+            }
+        }
+    }
+
+    // Update bullets
+    sim_update_bullets(g);
+
+    // Check for bullet-asteroid collisions
+    sim_check_bullet_collisions(g);
+    sim_compact_bullets(g);
+}
+
+// One full tick: gameplay, or the game over screen and the restart after it
+template <typename Sim>
+void sim_tick(GameState<Sim> *g, const EVENTS *key_events) {
+    g->tick++;
+    g->hit_count = 0;
+
+    // Check if game is over
+    if (!g->game_over && g->player.lives <= 0) {
+        TELEMETRY(EV_GAME_OVER, g->player.score, 0);
+        g->game_over = true;
+        g->game_over_timer = GAME_OVER_DURATION;
+    }
+
+    // Handle game over state
+    if (g->game_over) {
+        // Decrement game over timer
+        g->game_over_timer--;
+
+        // If game over timer has expired, reset the player, asteroids and bullets
+        if (g->game_over_timer <= 0) {
+            g->game_over = false;
+            sim_restart(g);
+        }
+
+        // Don't update game state while in game over screen
+        return;
+    }
+
+    sim_step(g, key_events);
+}
+
+// Field by field comparison, so padding bytes don't matter
+template <typename Sim>
+bool sim_state_equal(const GameState<Sim> *a, const GameState<Sim> *b) {
+    const PlayerT<Sim> *pa = &a->player;
+    const PlayerT<Sim> *pb = &b->player;
+    if (pa->x != pb->x || pa->y != pb->y || pa->velocity_x != pb->velocity_x || pa->velocity_y != pb->velocity_y ||
+        pa->rotation != pb->rotation || pa->lives != pb->lives || pa->score != pb->score ||
+        pa->invulnerable != pb->invulnerable || pa->invulnerable_timer != pb->invulnerable_timer) {
+        return false;
+    }
+    if (a->asteroid_count != b->asteroid_count || a->bullet_count != b->bullet_count || a->rng != b->rng ||
+        a->tick != b->tick || a->game_over != b->game_over || a->game_over_timer != b->game_over_timer) {
+        return false;
+    }
+    for (int i = 0; i < a->asteroid_count; i++) {
+        const AsteroidT<Sim> *aa = &a->asteroids[i];
+        const AsteroidT<Sim> *ab = &b->asteroids[i];
+        if (aa->x != ab->x || aa->y != ab->y || aa->width != ab->width || aa->height != ab->height ||
+            aa->speed_x != ab->speed_x || aa->speed_y != ab->speed_y) {
+            return false;
+        }
+    }
+    for (int i = 0; i < a->bullet_count; i++) {
+        const BulletT<Sim> *ba = &a->bullets[i];
+        const BulletT<Sim> *bb = &b->bullets[i];
+        if (ba->x != bb->x || ba->y != bb->y || ba->velocity_x != bb->velocity_x || ba->velocity_y != bb->velocity_y ||
+            ba->lifetime != bb->lifetime || ba->active != bb->active) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+#include "sim.h"
+#include <stddef.h> // For offsetof
+#include <type_traits>
+
+// Snapshots, rewind and rollback on top of GameState.
+// A snapshot is a plain copy of the state block, minus the unused tail of the
+// bullet array, so saving or restoring one costs a few microseconds.
+
+// Number of ticks of history kept (one second at 60 FPS). Must be a power of two.
+#ifndef SNAPSHOT_HISTORY
+#define SNAPSHOT_HISTORY 64
+#endif
+
+// How many packets can be in flight on a simulated link
+#define SIM_LINK_CAPACITY 256
+
+// Bytes of a state that hold live data
+template <typename Sim>
+static inline size_t snapshot_size(const GameState<Sim> *state) {
+    static_assert(std::is_trivially_copyable_v<GameState<Sim>>, "GameState must be copyable with memcpy");
+    static_assert(std::is_standard_layout_v<GameState<Sim>>, "GameState must be standard layout for offsetof");
+    return offsetof(GameState<Sim>, bullets) + sizeof(BulletT<Sim>) * state->bullet_count;
+}
+
+template <typename Sim>
+static inline void snapshot_copy(GameState<Sim> *dst, const GameState<Sim> *src) {
+    SDL_memcpy(dst, src, snapshot_size(src));
+}
+
+// Ring of the states at the start of each recent tick, with the input that tick
+// ran with and the telemetry counters as they were, so rewinding undoes those too
+template <typename Sim>
+struct SnapshotHistory {
+    GameState<Sim> states[SNAPSHOT_HISTORY];
+    EVENTS inputs[SNAPSHOT_HISTORY];
+    Uint32 counters[SNAPSHOT_HISTORY][EV_COUNT];
+    Uint32 oldest_tick; // Oldest tick still in the ring
+    Uint32 next_tick;   // One past the newest tick recorded
+};
+
+template <typename Sim>
+void history_reset(SnapshotHistory<Sim> *history, const GameState<Sim> *state) {
+    history->oldest_tick = state->tick;
+    history->next_tick = state->tick;
+}
+
+// Record the state before state->tick runs, and the input it will run with
+template <typename Sim>
+void history_record(SnapshotHistory<Sim> *history, const GameState<Sim> *state, const EVENTS *input) {
+    Uint32 tick = state->tick;
+    int slot = tick & (SNAPSHOT_HISTORY - 1);
+    snapshot_copy(&history->states[slot], state);
+    history->inputs[slot] = *input;
+    // Replays don't count, the slot keeps the counters from the first time round
+    if (!event_log.muted) {
+        SDL_memcpy(history->counters[slot], event_log.counters, sizeof(event_log.counters));
+    }
+    history->next_tick = tick + 1;
+    if (history->next_tick - history->oldest_tick > SNAPSHOT_HISTORY) {
+        history->oldest_tick = history->next_tick - SNAPSHOT_HISTORY;
+    }
+}
+
+template <typename Sim>
+bool history_contains(const SnapshotHistory<Sim> *history, Uint32 tick) {
+    return tick - history->oldest_tick < history->next_tick - history->oldest_tick;
+}
+
+// Restore the state as it was at the start of `tick`. Returns false if it is no longer in the ring.
+template <typename Sim>
+bool history_rewind(SnapshotHistory<Sim> *history, GameState<Sim> *state, Uint32 tick) {
+    if (!history_contains(history, tick)) {
+        return false;
+    }
+    int slot = tick & (SNAPSHOT_HISTORY - 1);
+    snapshot_copy(state, &history->states[slot]);
+    SDL_memcpy(event_log.counters, history->counters[slot], sizeof(event_log.counters));
+    // Everything after this point is about to be replaced
+    history->next_tick = tick;
+    return true;
+}
+
+// Change the input recorded for a tick, e.g. when a late remote input arrives
+template <typename Sim>
+void history_set_input(SnapshotHistory<Sim> *history, Uint32 tick, const EVENTS *input) {
+    history->inputs[tick & (SNAPSHOT_HISTORY - 1)] = *input;
+}
+
+template <typename Sim>
+const EVENTS *history_input(const SnapshotHistory<Sim> *history, Uint32 tick) {
+    return &history->inputs[tick & (SNAPSHOT_HISTORY - 1)];
+}
+
+// Rewind to `from_tick` and simulate forward again up to where we were, using the
+// recorded inputs (including any corrected with history_set_input).
+// Returns the number of ticks replayed, or -1 if from_tick is too old.
+template <typename Sim>
+int history_resimulate(SnapshotHistory<Sim> *history, GameState<Sim> *state, Uint32 from_tick) {
+    Uint32 target = state->tick;
+    if (!history_contains(history, from_tick) || from_tick > target) {
+        return -1;
+    }
+
+    // Replayed ticks already reported and counted their events the first time round
+    Uint32 counters[EV_COUNT];
+    SDL_memcpy(counters, event_log.counters, sizeof(counters));
+    bool was_muted = event_log.muted;
+    eventlog_set_muted(true);
+
+    history_rewind(history, state, from_tick);
+    int replayed = 0;
+    while (state->tick < target) {
+        EVENTS input = *history_input(history, state->tick);
+        history_record(history, state, &input);
+        sim_tick(state, &input);
+        replayed++;
+    }
+
+    eventlog_set_muted(was_muted);
+    SDL_memcpy(event_log.counters, counters, sizeof(counters));
+    return replayed;
+}
+
+// One direction of an in-process network link that delivers each packet
+// `latency` ticks after it was sent, plus up to `jitter` extra ticks
+struct SimLinkPacket {
+    Uint32 deliver_at;
+    Uint32 tick;
+    EVENTS input;
+};
+
+struct SimLink {
+    struct SimLinkPacket packets[SIM_LINK_CAPACITY];
+    int head;
+    int count;
+    int latency;
+    int jitter;
+    unsigned long rng;
+};
+
+static inline void sim_link_init(struct SimLink *link, int latency, int jitter, unsigned long seed) {
+    SDL_memset(link, 0, sizeof(*link));
+    link->latency = latency;
+    link->jitter = jitter;
+    link->rng = seed;
+}
+
+static inline bool sim_link_send(struct SimLink *link, Uint32 now, Uint32 tick, const EVENTS *input) {
+    if (link->count == SIM_LINK_CAPACITY) {
+        return false;
+    }
+    Uint32 delay = link->latency + (link->jitter ? random_range(&link->rng, 0, link->jitter) : 0);
+    struct SimLinkPacket *packet = &link->packets[(link->head + link->count) % SIM_LINK_CAPACITY];
+    // Packets never overtake each other, jitter only delays
+    Uint32 earliest = now + delay;
+    if (link->count) {
+        Uint32 last = link->packets[(link->head + link->count - 1) % SIM_LINK_CAPACITY].deliver_at;
+        earliest = SDL_max(earliest, last);
+    }
+    packet->deliver_at = earliest;
+    packet->tick = tick;
+    packet->input = *input;
+    link->count++;
+    return true;
+}
+
+static inline bool sim_link_receive(struct SimLink *link, Uint32 now, struct SimLinkPacket *out) {
+    if (!link->count || link->packets[link->head].deliver_at > now) {
+        return false;
+    }
+    *out = link->packets[link->head];
+    link->head = (link->head + 1) % SIM_LINK_CAPACITY;
+    link->count--;
+    return true;
+}
+
+static inline bool events_equal(const EVENTS *a, const EVENTS *b) {
+    return a->left_flag == b->left_flag && a->right_flag == b->right_flag &&
+           a->shoot_flag == b->shoot_flag && a->thrust_flag == b->thrust_flag;
+}
+
+// Both players fly the same ship, each one's buttons count
+static inline EVENTS merge_inputs(const EVENTS *a, const EVENTS *b) {
+    EVENTS merged;
+    merged.left_flag = a->left_flag || b->left_flag;
+    merged.right_flag = a->right_flag || b->right_flag;
+    merged.shoot_flag = a->shoot_flag || b->shoot_flag;
+    merged.thrust_flag = a->thrust_flag || b->thrust_flag;
+    return merged;
+}
+
+// One peer of a rollback session. Remote input that hasn't arrived yet is
+// predicted (repeat the last one we got); when the real one turns up and
+// differs, the session rewinds to that tick and simulates forward again.
+template <typename Sim>
+struct RollbackSession {
+    GameState<Sim> state;
+    SnapshotHistory<Sim> history;
+    EVENTS local_inputs[SNAPSHOT_HISTORY];
+    EVENTS remote_inputs[SNAPSHOT_HISTORY];
+    EVENTS last_remote;
+    Uint32 confirmed_tick; // Remote input is known for every tick before this
+    int rollbacks;
+    int ticks_replayed;
+    int max_replayed;
+    bool desynced; // A correction arrived for a tick that already left the history
+};
+
+template <typename Sim>
+void rollback_init(RollbackSession<Sim> *session, unsigned long seed) {
+    SDL_memset(session, 0, sizeof(*session));
+    sim_init(&session->state, seed);
+    history_reset(&session->history, &session->state);
+}
+
+// Apply remote inputs that arrived on `link`, rolling back if a prediction was wrong
+template <typename Sim>
+void rollback_receive(RollbackSession<Sim> *session, struct SimLink *link, Uint32 now) {
+    Uint32 current = session->state.tick;
+    Uint32 rollback_from = current;
+    struct SimLinkPacket packet;
+
+    while (sim_link_receive(link, now, &packet)) {
+        int slot = packet.tick & (SNAPSHOT_HISTORY - 1);
+        session->last_remote = packet.input;
+        session->confirmed_tick = packet.tick + 1;
+        if (packet.tick >= current) {
+            // Arrived before we needed it
+            session->remote_inputs[slot] = packet.input;
+            continue;
+        }
+        if (!events_equal(&session->remote_inputs[slot], &packet.input)) {
+            session->remote_inputs[slot] = packet.input;
+            EVENTS merged = merge_inputs(&session->local_inputs[slot], &packet.input);
+            history_set_input(&session->history, packet.tick, &merged);
+            rollback_from = SDL_min(rollback_from, packet.tick);
+        }
+    }
+
+    if (rollback_from < current) {
+        int replayed = history_resimulate(&session->history, &session->state, rollback_from);
+        if (replayed < 0) {
+            session->desynced = true;
+            return;
+        }
+        session->rollbacks++;
+        session->ticks_replayed += replayed;
+        session->max_replayed = SDL_max(session->max_replayed, replayed);
+    }
+}
+
+// Simulate the next tick with our input, predicting the remote one if needed, and send ours
+template <typename Sim>
+void rollback_advance(RollbackSession<Sim> *session, struct SimLink *link, Uint32 now, const EVENTS *local) {
+    Uint32 tick = session->state.tick;
+    int slot = tick & (SNAPSHOT_HISTORY - 1);
+    session->local_inputs[slot] = *local;
+    if (tick >= session->confirmed_tick) {
+        session->remote_inputs[slot] = session->last_remote;
+    }
+
+    EVENTS merged = merge_inputs(local, &session->remote_inputs[slot]);
+    history_record(&session->history, &session->state, &merged);
+    sim_tick(&session->state, &merged);
+
+    sim_link_send(link, now, tick, local);
+}
@@ -0,0 +1,298 @@
+#include "upscale.h"
+#include <utility> // For std::integer_sequence
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define UPSCALE_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define UPSCALE_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define UPSCALE_AVX2_TARGET
+#endif
+#endif
+
+// Only AArch64 has the table lookup we use for the NEON shuffles
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define UPSCALE_NEON 1
+#include <arm_neon.h>
+#endif
+
+static const char *kernel_names[UPSCALE_KERNEL_COUNT] = { "scalar", "sse2", "avx2", "neon" };
+
+// Row kernels: expand one source row horizontally, and apply the LED mask to an expanded row
+typedef void (*ExpandRowFn)(const Uint32 *src, Uint32 *dst, int width, int scale);
+typedef void (*MaskRowFn)(const Uint32 *src, Uint32 *dst, const Uint32 *full, const Uint32 *half, int count);
+
+static inline Uint32 half_brightness(Uint32 p) {
+    return (p >> 1) & 0x7F7F7F7F;
+}
+
+static void expand_row_scalar(const Uint32 *src, Uint32 *dst, int width, int scale) {
+    for (int x = 0; x < width; x++) {
+        Uint32 p = src[x];
+        for (int i = 0; i < scale; i++) {
+            *dst++ = p;
+        }
+    }
+}
+
+static void mask_row_scalar(const Uint32 *src, Uint32 *dst, const Uint32 *full, const Uint32 *half, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = (src[i] & full[i]) | (half_brightness(src[i]) & half[i]);
+    }
+}
+
+#ifdef UPSCALE_X86
+// SSE2 has no variable 32 bit shuffle, so every (scale, output vector) pair gets its own immediate
+template <int S, int J>
+static inline void sse2_store_part(Uint32 *dst, __m128i v) {
+    constexpr int imm = ((4 * J + 0) / S) | (((4 * J + 1) / S) << 2) | (((4 * J + 2) / S) << 4) | (((4 * J + 3) / S) << 6);
+    _mm_storeu_si128((__m128i *)(dst + 4 * J), _mm_shuffle_epi32(v, imm));
+}
+
+template <int S, int... J>
+static void sse2_expand(const Uint32 *src, Uint32 *dst, int width, std::integer_sequence<int, J...>) {
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + x));
+        (sse2_store_part<S, J>(dst + x * S, v), ...);
+    }
+    expand_row_scalar(src + x, dst + x * S, width - x, S);
+}
+
+static void expand_row_sse2(const Uint32 *src, Uint32 *dst, int width, int scale) {
+    switch (scale) {
+        case 2: sse2_expand<2>(src, dst, width, std::make_integer_sequence<int, 2>()); break;
+        case 3: sse2_expand<3>(src, dst, width, std::make_integer_sequence<int, 3>()); break;
+        case 4: sse2_expand<4>(src, dst, width, std::make_integer_sequence<int, 4>()); break;
+        case 5: sse2_expand<5>(src, dst, width, std::make_integer_sequence<int, 5>()); break;
+        case 6: sse2_expand<6>(src, dst, width, std::make_integer_sequence<int, 6>()); break;
+        case 7: sse2_expand<7>(src, dst, width, std::make_integer_sequence<int, 7>()); break;
+        case 8: sse2_expand<8>(src, dst, width, std::make_integer_sequence<int, 8>()); break;
+        default: expand_row_scalar(src, dst, width, scale); break;
+    }
+}
+
+static void mask_row_sse2(const Uint32 *src, Uint32 *dst, const Uint32 *full, const Uint32 *half, int count) {
+    const __m128i low7 = _mm_set1_epi8(0x7F);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i h = _mm_and_si128(_mm_srli_epi32(p, 1), low7);
+        __m128i f = _mm_and_si128(p, _mm_loadu_si128((const __m128i *)(full + i)));
+        h = _mm_and_si128(h, _mm_loadu_si128((const __m128i *)(half + i)));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(f, h));
+    }
+    mask_row_scalar(src + i, dst + i, full + i, half + i, count - i);
+}
+
+UPSCALE_AVX2_TARGET
+static void expand_row_avx2(const Uint32 *src, Uint32 *dst, int width, int scale) {
+    // Output vector j holds output pixels 8j..8j+7, which come from source pixels (8j+i)/scale
+    __m256i idx[UPSCALE_MAX];
+    for (int j = 0; j < scale; j++) {
+        alignas(32) int lanes[8];
+        for (int i = 0; i < 8; i++) {
+            lanes[i] = (8 * j + i) / scale;
+        }
+        idx[j] = _mm256_load_si256((const __m256i *)lanes);
+    }
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(src + x));
+        Uint32 *out = dst + x * scale;
+        for (int j = 0; j < scale; j++) {
+            _mm256_storeu_si256((__m256i *)(out + 8 * j), _mm256_permutevar8x32_epi32(v, idx[j]));
+        }
+    }
+    expand_row_scalar(src + x, dst + x * scale, width - x, scale);
+}
+
+UPSCALE_AVX2_TARGET
+static void mask_row_avx2(const Uint32 *src, Uint32 *dst, const Uint32 *full, const Uint32 *half, int count) {
+    const __m256i low7 = _mm256_set1_epi8(0x7F);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i h = _mm256_and_si256(_mm256_srli_epi32(p, 1), low7);
+        __m256i f = _mm256_and_si256(p, _mm256_loadu_si256((const __m256i *)(full + i)));
+        h = _mm256_and_si256(h, _mm256_loadu_si256((const __m256i *)(half + i)));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_or_si256(f, h));
+    }
+    mask_row_scalar(src + i, dst + i, full + i, half + i, count - i);
+}
+#endif
+
+#ifdef UPSCALE_NEON
+static void expand_row_neon(const Uint32 *src, Uint32 *dst, int width, int scale) {
+    // Byte shuffle tables, output vector j takes source pixel (4j+i)/scale for lane i
+    uint8x16_t idx[UPSCALE_MAX];
+    for (int j = 0; j < scale; j++) {
+        uint8_t lanes[16];
+        for (int i = 0; i < 4; i++) {
+            int p = (4 * j + i) / scale;
+            for (int b = 0; b < 4; b++) {
+                lanes[i * 4 + b] = (uint8_t)(p * 4 + b);
+            }
+        }
+        idx[j] = vld1q_u8(lanes);
+    }
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        uint8x16_t v = vld1q_u8((const uint8_t *)(src + x));
+        Uint32 *out = dst + x * scale;
+        for (int j = 0; j < scale; j++) {
+            vst1q_u8((uint8_t *)(out + 4 * j), vqtbl1q_u8(v, idx[j]));
+        }
+    }
+    expand_row_scalar(src + x, dst + x * scale, width - x, scale);
+}
+
+static void mask_row_neon(const Uint32 *src, Uint32 *dst, const Uint32 *full, const Uint32 *half, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t p = vld1q_u32(src + i);
+        // Shifting each byte on its own gives the half brightness pixel without a mask
+        uint32x4_t h = vreinterpretq_u32_u8(vshrq_n_u8(vreinterpretq_u8_u32(p), 1));
+        uint32x4_t out = vorrq_u32(vandq_u32(p, vld1q_u32(full + i)), vandq_u32(h, vld1q_u32(half + i)));
+        vst1q_u32(dst + i, out);
+    }
+    mask_row_scalar(src + i, dst + i, full + i, half + i, count - i);
+}
+#endif
+
+bool upscale_kernel_supported(UpscaleKernel kernel) {
+    switch (kernel) {
+        case UPSCALE_SCALAR:
+            return true;
+#ifdef UPSCALE_X86
+        case UPSCALE_SSE2:
+            return SDL_HasSSE2();
+        case UPSCALE_AVX2:
+            return SDL_HasAVX2();
+#endif
+#ifdef UPSCALE_NEON
+        case UPSCALE_NEON:
+            return SDL_HasNEON();
+#endif
+        default:
+            return false;
+    }
+}
+
+UpscaleKernel upscale_best_kernel() {
+    const UpscaleKernel preference[] = { UPSCALE_AVX2, UPSCALE_NEON, UPSCALE_SSE2 };
+    for (UpscaleKernel kernel : preference) {
+        if (upscale_kernel_supported(kernel)) {
+            return kernel;
+        }
+    }
+    return UPSCALE_SCALAR;
+}
+
+const char *upscale_kernel_name(UpscaleKernel kernel) {
+    if (kernel < 0 || kernel >= UPSCALE_KERNEL_COUNT) {
+        return "unknown";
+    }
+    return kernel_names[kernel];
+}
+
+// Brightness of sub-pixel (sx, sy) of one scaled pixel: 2 = full, 1 = half, 0 = off.
+// The last row and column of each cell are the gap between dots, and from 4x up
+// the dot also gets rounded corners.
+static int led_level(int sx, int sy, int scale) {
+    int inner = scale - 1;
+    if (sx == inner || sy == inner) {
+        return scale >= 3 ? 0 : 1;
+    }
+    bool edge_x = (sx == 0 || sx == inner - 1);
+    bool edge_y = (sy == 0 || sy == inner - 1);
+    if (scale >= 4 && edge_x && edge_y) {
+        return 1;
+    }
+    return 2;
+}
+
+bool upscaler_init(struct Upscaler *up, int src_width, int src_height, int scale, bool led_mask) {
+    SDL_memset(up, 0, sizeof(*up));
+    if (scale < UPSCALE_MIN || scale > UPSCALE_MAX) {
+        return false;
+    }
+    up->scale = scale;
+    up->src_width = src_width;
+    up->src_height = src_height;
+    up->led_mask = led_mask;
+    up->kernel = upscale_best_kernel();
+
+    if (led_mask) {
+        int row = src_width * scale;
+        up->mask_full = (Uint32 *)SDL_aligned_alloc(64, sizeof(Uint32) * row * scale);
+        up->mask_half = (Uint32 *)SDL_aligned_alloc(64, sizeof(Uint32) * row * scale);
+        if (!up->mask_full || !up->mask_half) {
+            upscaler_destroy(up);
+            return false;
+        }
+        for (int sy = 0; sy < scale; sy++) {
+            for (int x = 0; x < row; x++) {
+                int level = led_level(x % scale, sy, scale);
+                up->mask_full[sy * row + x] = (level == 2) ? 0xFFFFFFFF : 0;
+                up->mask_half[sy * row + x] = (level == 1) ? 0xFFFFFFFF : 0;
+            }
+        }
+    }
+    return true;
+}
+
+void upscaler_destroy(struct Upscaler *up) {
+    SDL_aligned_free(up->mask_full);
+    SDL_aligned_free(up->mask_half);
+    up->mask_full = NULL;
+    up->mask_half = NULL;
+}
+
+void upscale(const struct Upscaler *up, const char *src, int src_pitch, char *dst, int dst_pitch) {
+    ExpandRowFn expand = expand_row_scalar;
+    MaskRowFn mask = mask_row_scalar;
+    switch (up->kernel) {
+#ifdef UPSCALE_X86
+        case UPSCALE_SSE2:
+            expand = expand_row_sse2;
+            mask = mask_row_sse2;
+            break;
+        case UPSCALE_AVX2:
+            expand = expand_row_avx2;
+            mask = mask_row_avx2;
+            break;
+#endif
+#ifdef UPSCALE_NEON
+        case UPSCALE_NEON:
+            expand = expand_row_neon;
+            mask = mask_row_neon;
+            break;
+#endif
+        default:
+            break;
+    }
+
+    const int scale = up->scale;
+    const int row = up->src_width * scale;
+    for (int y = 0; y < up->src_height; y++) {
+        const Uint32 *src_row = (const Uint32 *)(src + y * src_pitch);
+        char *out = dst + (size_t)y * scale * dst_pitch;
+
+        // Expand into the first output line, then derive the other lines of this source row from it
+        Uint32 *first = (Uint32 *)out;
+        expand(src_row, first, up->src_width, scale);
+        if (up->led_mask) {
+            for (int sy = scale - 1; sy >= 0; sy--) {
+                mask(first, (Uint32 *)(out + sy * dst_pitch), up->mask_full + sy * row, up->mask_half + sy * row, row);
+            }
+        } else {
+            for (int sy = 1; sy < scale; sy++) {
+                SDL_memcpy(out + sy * dst_pitch, first, sizeof(Uint32) * row);
+            }
+        }
+    }
+}
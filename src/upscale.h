@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#define UPSCALE_MIN 2
+#define UPSCALE_MAX 8
+
+// Implementations of the scaling kernel, picked at runtime from what the CPU supports
+enum UpscaleKernel {
+    UPSCALE_SCALAR,
+    UPSCALE_SSE2,
+    UPSCALE_AVX2,
+    UPSCALE_NEON,
+    UPSCALE_KERNEL_COUNT
+};
+
+// Nearest neighbour integer upscaler for 32 bit pixels.
+// With led_mask set every scaled pixel is shaped like a dot of the physical
+// panel, by darkening the gap between dots.
+struct Upscaler {
+    int scale;
+    int src_width;
+    int src_height;
+    bool led_mask;
+    UpscaleKernel kernel;
+
+    // One row of masks per line of a scaled pixel, src_width * scale entries each.
+    // Output = (pixel & full) | (half brightness pixel & half)
+    Uint32 *mask_full;
+    Uint32 *mask_half;
+};
+
+// Returns false if the scale is out of range or allocation failed
+bool upscaler_init(struct Upscaler *up, int src_width, int src_height, int scale, bool led_mask);
+void upscaler_destroy(struct Upscaler *up);
+
+// Scale src (src_width x src_height) into dst (scale times larger in both directions)
+void upscale(const struct Upscaler *up, const char *src, int src_pitch, char *dst, int dst_pitch);
+
+bool upscale_kernel_supported(UpscaleKernel kernel);
+UpscaleKernel upscale_best_kernel();
+const char *upscale_kernel_name(UpscaleKernel kernel);